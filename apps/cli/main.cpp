@@ -1,11 +1,21 @@
 #include <simpleble/SimpleBLE.h>
+#include "hub/Frame.h"
 #include "hub/Framer.h"
 #include "hub/Parser.h"
 #include "hub/Pipeline.h"
-#include "hub/model/Linear.h"
-
+#include "hub/ReplayReader.h"
+#include "hub/Resampler.h"
+#include "hub/Simulator.h"
+#include "hub/SpscRing.h"
+#include "hub/StreamDecoder.h"
+#include "hub/model/BruteForce_16x2.h"
+
+#include <algorithm>
 #include <atomic>
+#include <cerrno>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -17,6 +27,12 @@
 #include <thread>
 #include <vector>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
 static inline uint64_t now_ns() {
     using namespace std::chrono;
     return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
@@ -30,6 +46,17 @@ struct Args {
     std::string prefix = "Softionics";
     int scan_ms = 3000;
 
+    // Replay or simulator instead of BLE.
+    std::string replay_path;
+    hub::ReplayConfig replay;
+
+    bool sim = false;
+    bool sim_pty = false;   // serve the simulator on a pseudo-terminal instead
+    hub::SimConfig sim_cfg;
+
+    double speed = 1.0;
+    double seconds = 0.0;   // stop after this long, 0 = run until done / 'q'
+
     bool ma_on = false;
     size_t ma_win = 5;
 
@@ -40,17 +67,60 @@ struct Args {
     double fs = 200.0;
     double notch_f0 = 60.0;
     double notch_q = 30.0;
+    int notch_harmonics = 1;
 
     bool bias_on = false;
     size_t bias_capture_frames = 200;
 
-    bool model_on = true;
-    float model_bias = 0.0f;
-    std::string weights_csv;
+    std::vector<hub::StageSpec> chain;   // overrides the flags above when set
+
+    bool resample = false;
+    hub::ResamplerConfig resample_cfg;   // fs_hz follows --fs
 
     std::string csv_path;
+
+    bool bench_parser = false;
+    bool bench_pipeline = false;
+    bool bench_solver = false;
 };
 
+static void usage() {
+    std::cerr <<
+        "usage: softionics_hub_cli [options]\n"
+        "  source (default: first BLE device whose name starts with --prefix)\n"
+        "    --prefix NAME  --scan_ms MS\n"
+        "    --replay FILE      recording CSV or raw capture\n"
+        "    --raw_rate B       raw captures: bytes/s at speed 1 (default: unpaced)\n"
+        "    --loop\n"
+        "    --sim              simulated 16-channel pad (ground truth known)\n"
+        "    --sim_pty          serve the simulator on a pseudo-terminal (open it as a serial port)\n"
+        "    --sim_rate HZ  --sim_fpp N (frames per packet)  --sim_binary  --sim_loss P\n"
+        "    --sim_noise V  --sim_hum V  --sim_drift V  --sim_seed N\n"
+        "    --speed X          replay/simulator: 1 = real time (default), N = N times faster,\n"
+        "                       0 = as fast as possible\n"
+        "    --seconds S        stop after S seconds\n"
+        "  pipeline\n"
+        "    --ma N | --no_ma   --ema_alpha A | --no_ema   --notch F0 | --no_notch  --q Q  --fs HZ\n"
+        "    --harmonics N      notch F0 and its first N harmonics (mains hum)\n"
+        "    --bias | --no_bias  --bias_frames N\n"
+        "    --chain SPEC       explicit stage order instead of the flags above,\n"
+        "                       e.g. \"ma:5,ema:0.2,notch:60:30,bias\" (stages may repeat);\n"
+        "                       hum:F0[:HARMONICS[:Q]]\n"
+        "                       IIR: lp:FC hp:FC bp:F1:F2, each [:ORDER[:RIPPLE_DB]] (uses --fs)\n"
+        "                       FIR: fir:KERNEL_FILE, or firlp:FC firhp:FC firbp:F1:F2, each [:TAPS]\n"
+        "                       spikes: median:W  hampel:W[:K]\n"
+        "    --resample         interpolate frames onto a uniform --fs grid (from their\n"
+        "                       timestamps) before the pipeline\n"
+        "    --resample_sinc W  windowed-sinc instead of linear, W input periods each side\n"
+        "  output\n"
+        "    --csv FILE         processed frames, same format as the GUI recorder\n"
+        "  other\n"
+        "    --bench_parser     lines/s of CsvFloatParser parse_line(), parse_into(), parse_block() and exit\n"
+        "    --bench_pipeline   time the filter chain (all stages) per SIMD level and exit\n"
+        "    --bench_solver     time the BruteForce grid solve per grid size (scalar, avx2, pyramid),\n"
+        "                       compare pyramid, full scan and truth on --sim_* frames, and exit\n";
+}
+
 static Args parse_args(int argc, char** argv) {
     Args a;
     for (int i = 1; i < argc; ++i) {
@@ -67,6 +137,24 @@ static Args parse_args(int argc, char** argv) {
         if (k == "--prefix") a.prefix = need("--prefix");
         else if (k == "--scan_ms") a.scan_ms = std::atoi(need("--scan_ms"));
 
+        else if (k == "--replay") a.replay_path = need("--replay");
+        else if (k == "--raw_rate") a.replay.raw_bytes_per_s = std::strtod(need("--raw_rate"), nullptr);
+        else if (k == "--loop") a.replay.loop = true;
+
+        else if (k == "--sim") a.sim = true;
+        else if (k == "--sim_pty") a.sim_pty = true;
+        else if (k == "--sim_rate") a.sim_cfg.fs_hz = std::strtod(need("--sim_rate"), nullptr);
+        else if (k == "--sim_fpp") a.sim_cfg.frames_per_packet = static_cast<size_t>(std::strtoul(need("--sim_fpp"), nullptr, 10));
+        else if (k == "--sim_binary") a.sim_cfg.wire = hub::WireFormat::Binary;
+        else if (k == "--sim_loss") a.sim_cfg.loss = std::strtod(need("--sim_loss"), nullptr);
+        else if (k == "--sim_noise") a.sim_cfg.noise_rms = std::strtod(need("--sim_noise"), nullptr);
+        else if (k == "--sim_hum") a.sim_cfg.hum_amp = std::strtod(need("--sim_hum"), nullptr);
+        else if (k == "--sim_drift") a.sim_cfg.drift_rms = std::strtod(need("--sim_drift"), nullptr);
+        else if (k == "--sim_seed") a.sim_cfg.seed = static_cast<uint32_t>(std::strtoul(need("--sim_seed"), nullptr, 10));
+
+        else if (k == "--speed") a.speed = std::strtod(need("--speed"), nullptr);
+        else if (k == "--seconds") a.seconds = std::strtod(need("--seconds"), nullptr);
+
         else if (k == "--ma") { a.ma_on = true; a.ma_win = static_cast<size_t>(std::strtoul(need("--ma"), nullptr, 10)); }
         else if (k == "--no_ma") a.ma_on = false;
 
@@ -75,6 +163,7 @@ static Args parse_args(int argc, char** argv) {
 
         else if (k == "--notch") { a.notch_on = true; a.notch_f0 = std::strtod(need("--notch"), nullptr); }
         else if (k == "--q") a.notch_q = std::strtod(need("--q"), nullptr);
+        else if (k == "--harmonics") a.notch_harmonics = std::atoi(need("--harmonics"));
         else if (k == "--fs") a.fs = std::strtod(need("--fs"), nullptr);
         else if (k == "--no_notch") a.notch_on = false;
 
@@ -82,20 +171,114 @@ static Args parse_args(int argc, char** argv) {
         else if (k == "--no_bias") a.bias_on = false;
         else if (k == "--bias_frames") a.bias_capture_frames = static_cast<size_t>(std::strtoul(need("--bias_frames"), nullptr, 10));
 
-        else if (k == "--model") a.model_on = true;
-        else if (k == "--no_model") a.model_on = false;
-        else if (k == "--model_bias") a.model_bias = std::strtof(need("--model_bias"), nullptr);
-        else if (k == "--weights") a.weights_csv = need("--weights");
+        else if (k == "--chain") {
+            std::string err;
+            if (!hub::parse_stage_chain(need("--chain"), a.chain, err)) {
+                std::cerr << "--chain: " << err << "\n";
+                std::exit(2);
+            }
+        }
+
+        else if (k == "--resample") a.resample = true;
+        else if (k == "--resample_sinc") {
+            a.resample = true;
+            a.resample_cfg.method = hub::ResampleMethod::Sinc;
+            a.resample_cfg.half_width = std::atoi(need("--resample_sinc"));
+        }
 
         else if (k == "--csv") a.csv_path = need("--csv");
+        else if (k == "--bench_parser") a.bench_parser = true;
+        else if (k == "--bench_pipeline") a.bench_pipeline = true;
+        else if (k == "--bench_solver") a.bench_solver = true;
+        else if (k == "-h" || k == "--help") { usage(); std::exit(0); }
         else {
             std::cerr << "Unknown arg: " << k << "\n";
+            usage();
             std::exit(2);
         }
     }
+    a.replay.speed = a.speed;
+    a.resample_cfg.fs_hz = a.fs;
     return a;
 }
 
+// Lines/s of the CSV parser on synthetic device lines ("%.3f" values, as the
+// firmware prints them): the allocating parse_line(), parse_into() into a
+// reused buffer, and parse_block() draining a framer the way the decoder does.
+static int run_bench_parser() {
+    constexpr size_t kLines = 1u << 14;
+    constexpr size_t kBytes = 1u << 26;   // per measurement
+
+    std::printf("parser bench: %zu distinct lines, ~%zu MB parsed per measurement\n", kLines, kBytes >> 20);
+
+    for (size_t n : {16u, 64u, 600u}) {
+        std::string text;
+        std::vector<size_t> ends;
+        uint32_t seed = 1;
+        char buf[32];
+        for (size_t i = 0; i < kLines; ++i) {
+            for (size_t c = 0; c < n; ++c) {
+                seed = seed * 1664525u + 1013904223u;
+                const double v = ((double)(seed >> 8) * (1.0 / 16777216.0) - 0.5) * 6.6;
+                int m = std::snprintf(buf, sizeof(buf), c ? ",%.3f" : "%.3f", v);
+                text.append(buf, (size_t)m);
+            }
+            text.push_back('\n');
+            ends.push_back(text.size());
+        }
+        const size_t rounds = std::max<size_t>(1, kBytes / text.size());
+        const double lines = (double)(rounds * kLines);
+
+        auto report = [&](const char* what, uint64_t t0, double sink) {
+            const double s = (double)(now_ns() - t0) * 1e-9;
+            std::printf("  %3zu ch  %-12s %7.2f Mlines/s  %7.1f MB/s  (%g)\n", n, what, lines / s * 1e-6,
+                        (double)(rounds * text.size()) / s * 1e-6, sink);
+        };
+
+        hub::CsvFloatParser parser;
+        {
+            double sink = 0;
+            uint64_t t0 = now_ns();
+            for (size_t r = 0; r < rounds; ++r) {
+                size_t b = 0;
+                for (size_t e : ends) {
+                    auto v = parser.parse_line(std::string_view(text).substr(b, e - 1 - b));
+                    if (v) sink += (*v)[0];
+                    b = e;
+                }
+            }
+            report("parse_line", t0, sink);
+        }
+        {
+            std::vector<float> out(n);
+            double sink = 0;
+            uint64_t t0 = now_ns();
+            for (size_t r = 0; r < rounds; ++r) {
+                size_t b = 0;
+                for (size_t e : ends) {
+                    if (parser.parse_into(std::string_view(text).substr(b, e - 1 - b), out.data(), n)) sink += out[0];
+                    b = e;
+                }
+            }
+            report("parse_into", t0, sink);
+        }
+        {
+            hub::LineFramer framer;
+            hub::FrameBlock blk;
+            double sink = 0;
+            uint64_t t0 = now_ns();
+            for (size_t r = 0; r < rounds; ++r) {
+                blk.clear();
+                framer.feed(text);
+                parser.parse_block(framer, r, blk);
+                sink += blk.row(0)[0];
+            }
+            report("parse_block", t0, sink);
+        }
+    }
+    return 0;
+}
+
 static std::optional<std::pair<SimpleBLE::BluetoothUUID, SimpleBLE::BluetoothUUID>>
 pick_first_notify_char(SimpleBLE::Peripheral& p) {
     auto services = p.services();
@@ -108,66 +291,472 @@ pick_first_notify_char(SimpleBLE::Peripheral& p) {
     return std::nullopt;
 }
 
-int main(int argc, char** argv) {
-    Args args = parse_args(argc, argv);
+// Same path as the GUI worker: transport -> ring -> decoder -> pipeline, with
+// the decoding on its own thread.
+class Ingest {
+public:
+    Ingest(const hub::PipelineConfig& cfg, std::ofstream* csv, const hub::ResamplerConfig* resample)
+        : resample_(resample != nullptr), csv_(csv) {
+        pipe_.set_config(cfg);
+        if (resample) resampler_.configure(*resample);
+    }
 
-    if (!SimpleBLE::Adapter::bluetooth_enabled()) {
-        std::cerr << "Bluetooth not enabled or permission missing\n";
-        return 1;
+    void start(const hub::CsvLayout& layout, bool line_sync) {
+        decoder_.set_layout(layout);
+        decoder_.set_line_sync(line_sync);
+        decoder_.reset();
+        ring_.reset();
+        run_.store(true);
+        thread_ = std::thread([this]() { this->loop(); });
     }
 
-    auto adapters = SimpleBLE::Adapter::get_adapters();
-    if (adapters.empty()) {
-        std::cerr << "No adapters\n";
+    // Stops once everything written so far has been processed.
+    void drain_and_stop() {
+        while (ring_.size() > 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        run_.store(false);
+        wake_.notify_one();
+        if (thread_.joinable()) thread_.join();
+    }
+
+    void wake() {
+        if (idle_.load(std::memory_order_relaxed)) wake_.notify_one();
+    }
+
+    void request_bias_capture(size_t frames) { bias_request_.store(frames); }
+
+    hub::SpscByteRing& ring() { return ring_; }
+    const hub::SpscByteRing& ring() const { return ring_; }
+
+    uint64_t frames() const { return frames_.load(); }
+    uint64_t bad() const { return bad_.load(); }
+    uint64_t bytes() const { return bytes_.load(); }
+    uint64_t lost() const { return lost_.load(); }
+    double rate_hz() const { return rate_.load(); }
+
+private:
+    void loop() {
+        while (run_.load()) {
+            const char* p = nullptr;
+            size_t n = ring_.read_span(p);
+            if (n > 0) {
+                process(std::string_view(p, n));
+                ring_.consume(n);
+                bytes_.fetch_add(n, std::memory_order_relaxed);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lk(wake_mu_);
+            idle_.store(true);
+            wake_.wait_for(lk, std::chrono::milliseconds(2));
+            idle_.store(false);
+        }
+    }
+
+    void process(std::string_view chunk) {
+        size_t nbad = decoder_.decode(chunk, now_ns(), blk_);
+        if (nbad) bad_.fetch_add(nbad);
+        lost_.store(decoder_.lost());
+        rate_.store(decoder_.rate_hz());
+        if (blk_.n_frames == 0) return;
+
+        if (resample_) {
+            grid_.clear();
+            resampler_.process(blk_, grid_);
+        }
+        hub::FrameBlock& blk = resample_ ? grid_ : blk_;
+        if (blk.n_frames == 0) return;
+
+        const size_t n = blk.n_ch;
+        pipe_.ensure_initialized(n);
+
+        size_t cap = bias_request_.exchange(0);
+        if (cap) pipe_.begin_bias_capture(cap);
+
+        pipe_.process_block(blk);
+
+        if (csv_) write_csv(blk);
+        frames_.fetch_add(blk.n_frames);
+    }
+
+    void write_csv(const hub::FrameBlock& blk) {
+        const size_t n = blk.n_ch;
+        if (csv_t0_ == 0) {
+            csv_t0_ = blk.t_ns[0];
+            (*csv_) << "t";
+            for (size_t c = 0; c < n; ++c) (*csv_) << ",ch" << c;
+            (*csv_) << "\n";
+        }
+        for (size_t i = 0; i < blk.n_frames; ++i) {
+            const float* x = blk.row(i);
+            char ts[32];
+            std::snprintf(ts, sizeof(ts), "%.6f", (double)(blk.t_ns[i] - csv_t0_) * 1e-9);
+            (*csv_) << ts;
+            for (size_t c = 0; c < n; ++c) (*csv_) << "," << x[c];
+            (*csv_) << "\n";
+        }
+    }
+
+    hub::SpscByteRing ring_{1u << 20};
+    hub::StreamDecoder decoder_;
+    hub::FrameBlock blk_;
+    hub::Pipeline pipe_;
+
+    bool resample_ = false;
+    hub::Resampler resampler_;
+    hub::FrameBlock grid_;        // blk_ on the uniform grid
+
+    std::ofstream* csv_ = nullptr;
+    uint64_t csv_t0_ = 0;
+
+    std::thread thread_;
+    std::atomic<bool> run_{false};
+    std::atomic<bool> idle_{false};
+    std::mutex wake_mu_;
+    std::condition_variable wake_;
+
+    std::atomic<size_t> bias_request_{0};
+
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> bad_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> lost_{0};
+    std::atomic<double> rate_{0.0};
+};
+
+static void print_report(const char* tag, Ingest& ing, uint64_t frames, uint64_t bytes, double dt) {
+    const auto& ring = ing.ring();
+    std::printf("%s frames=%llu  %.0f fr/s  %.2f MB/s  fs=%.2f Hz  bad=%llu lost=%llu  ring peak=%zu KiB overflow=%llu B\n",
+                tag, (unsigned long long)frames,
+                dt > 0.0 ? (double)frames / dt : 0.0,
+                dt > 0.0 ? (double)bytes / dt / 1e6 : 0.0,
+                ing.rate_hz(), (unsigned long long)ing.bad(), (unsigned long long)ing.lost(),
+                ring.high_water() / 1024, (unsigned long long)ring.overflow_bytes());
+    std::fflush(stdout);
+}
+
+// Serves the simulator on a pseudo-terminal, so the GUI or any serial tool can
+// open it like a device.
+static int run_sim_pty(const Args& args) {
+#ifdef _WIN32
+    (void)args;
+    std::cerr << "--sim_pty needs a POSIX system (use a virtual COM pair and --sim on Windows)\n";
+    return 1;
+#else
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+        std::perror("posix_openpt");
         return 1;
     }
-    auto adapter = adapters[0];
 
-    std::cout << "Adapter: " << adapter.identifier() << " " << adapter.address() << "\n";
+    termios tio{};
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    std::cout << "Simulator on " << ptsname(fd) << "  (" << args.sim_cfg.fs_hz << " Hz, "
+              << (args.sim_cfg.wire == hub::WireFormat::Binary ? "binary" : "CSV seq,t_us,ch0..ch15")
+              << ", speed=" << args.speed << ")\n";
+    std::cout.flush();
+
+    hub::SpscByteRing ring(1u << 20);
+    hub::SimulatorReader sim;
+    sim.start(args.sim_cfg, args.speed, ring, nullptr);
 
-    SimpleBLE::Peripheral chosen;
-    bool found = false;
+    const uint64_t t0 = now_ns();
+    uint64_t last_t = t0;
+    uint64_t written = 0;
+    uint64_t dropped = 0;
 
     for (;;) {
-        adapter.scan_for(args.scan_ms);
-        auto results = adapter.scan_get_results();
-
-        int best_rssi = -32768;
-        for (auto& p : results) {
-            auto name = p.identifier();
-            if (!starts_with(name, args.prefix)) continue;
-            int rssi = p.rssi();
-            if (!found || rssi > best_rssi) {
-                chosen = p;
-                best_rssi = rssi;
-                found = true;
+        uint64_t t = now_ns();
+        if (args.seconds > 0.0 && (double)(t - t0) * 1e-9 >= args.seconds) break;
+
+        const char* p = nullptr;
+        size_t n = ring.read_span(p);
+        if (n == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        } else {
+            // Nobody reading (or reading too slowly): drop like a real UART would.
+            ssize_t w = ::write(fd, p, n);
+            if (w > 0) {
+                written += (uint64_t)w;
+                n = (size_t)w;
+            } else {
+                dropped += n;
+                if (errno == EAGAIN || errno == EIO) std::this_thread::sleep_for(std::chrono::milliseconds(1));
             }
+            ring.consume(n);
         }
 
-        if (found) break;
-        std::cout << "Scanning... no match yet\n";
+        if (t - last_t >= 1000000000ULL) {
+            last_t = t;
+            std::printf("frames=%llu lost(sim)=%llu written=%llu B dropped=%llu B\n",
+                        (unsigned long long)sim.frames(), (unsigned long long)sim.dropped_frames(),
+                        (unsigned long long)written, (unsigned long long)dropped);
+            std::fflush(stdout);
+        }
     }
 
-    std::cout << "Chosen: " << chosen.identifier() << " " << chosen.address() << " rssi=" << chosen.rssi() << "\n";
+    sim.close();
+    ::close(fd);
+    return 0;
+#endif
+}
 
-    chosen.connect();
-    std::cout << "Connected\n";
+// Samples/s of the full chain (MA, EMA, notch, bias) for a few channel counts:
+// process() frame by frame (vector and in-place), then process_block() at each
+// SIMD level, then a few SOS, FIR and median stages on their own.
+static int run_bench_pipeline() {
+    static const char* kLevelName[] = {"scalar", "sse2", "avx2"};
+    constexpr size_t kBlockFrames = 64;
+    constexpr size_t kSamples = 1u << 24;   // per measurement
 
-    auto notify_pair = pick_first_notify_char(chosen);
-    if (!notify_pair) {
-        std::cerr << "No notify characteristic found\n";
-        return 1;
+    hub::PipelineConfig cfg;
+    cfg.enable_ma = true;
+    cfg.enable_ema = true;
+    cfg.enable_notch = true;
+    cfg.enable_bias = true;
+
+    std::printf("pipeline bench: MA(%zu) EMA notch(%.0f Hz) bias, %zu frames/block, detected %s\n",
+                cfg.ma_win, cfg.notch_f0, kBlockFrames, kLevelName[(int)hub::Pipeline::detected_simd()]);
+
+    for (size_t n : {16u, 64u, 256u}) {
+        hub::FrameBlock src;
+        src.n_ch = n;
+        uint32_t seed = 1;
+        for (size_t i = 0; i < kBlockFrames; ++i) {
+            float* x = src.append(i * 5000000ULL);
+            for (size_t c = 0; c < n; ++c) {
+                seed = seed * 1664525u + 1013904223u;
+                x[c] = (float)(seed >> 8) * (1.0f / 16777216.0f);
+            }
+        }
+        const size_t rounds = kSamples / (n * kBlockFrames);
+
+        auto make = [&](hub::SimdLevel level) {
+            hub::Pipeline p;
+            p.set_config(cfg);
+            p.set_simd(level);
+            p.ensure_initialized(n);
+            p.begin_bias_capture(1);
+            return p;
+        };
+        auto report = [&](const char* what, uint64_t t0, float sink) {
+            double s = (double)(now_ns() - t0) * 1e-9;
+            std::printf("  %3zu ch  %-18s %8.1f Msamples/s  (%g)\n", n, what,
+                        (double)(rounds * kBlockFrames * n) / s * 1e-6, (double)sink);
+        };
+
+        {
+            hub::Pipeline p = make(hub::Pipeline::detected_simd());
+            std::vector<float> in(n);
+            float sink = 0;
+            uint64_t t0 = now_ns();
+            for (size_t r = 0; r < rounds; ++r) {
+                for (size_t i = 0; i < kBlockFrames; ++i) {
+                    in.assign(src.row(i), src.row(i) + n);
+                    sink += p.process(src.t_ns[i], in).frame.x[0];
+                }
+            }
+            report("process(vector)", t0, sink);
+        }
+
+        {
+            hub::Pipeline p = make(hub::Pipeline::detected_simd());
+            std::vector<float> out(n);
+            float sink = 0;
+            uint64_t t0 = now_ns();
+            for (size_t r = 0; r < rounds; ++r) {
+                for (size_t i = 0; i < kBlockFrames; ++i) {
+                    p.process(src.row(i), out.data(), n);
+                    sink += out[0];
+                }
+            }
+            report("process(float*)", t0, sink);
+        }
+
+        hub::FrameBlock blk = src;
+        for (int lv = 0; lv <= (int)hub::Pipeline::detected_simd(); ++lv) {
+            hub::Pipeline p = make((hub::SimdLevel)lv);
+            float sink = 0;
+            uint64_t t0 = now_ns();
+            for (size_t r = 0; r < rounds; ++r) {
+                std::copy(src.x.begin(), src.x.end(), blk.x.begin());
+                p.process_block(blk);
+                sink += blk.x[0];
+            }
+            std::string what = std::string("block ") + kLevelName[lv];
+            report(what.c_str(), t0, sink);
+        }
+
+        // Single stages: one notch, a 4-line hum bank, an order-16 low-pass, and
+        // a short (direct form) and a long (overlap-save) FIR low-pass, and the
+        // longest median window the spike filters are meant for.
+        for (const char* chain : {"notch:60", "hum:60:4", "lp:20:16", "firlp:20:31", "firlp:20:255",
+                                  "median:101", "hampel:101"}) {
+            hub::PipelineConfig one;
+            one.fs_hz = 1000.0;
+            std::string err;
+            hub::parse_stage_chain(chain, one.stages, err);
+            hub::Pipeline p;
+            p.set_config(one);
+            p.ensure_initialized(n);
+            float sink = 0;
+            uint64_t t0 = now_ns();
+            for (size_t r = 0; r < rounds; ++r) {
+                std::copy(src.x.begin(), src.x.end(), blk.x.begin());
+                p.process_block(blk);
+                sink += blk.x[0];
+            }
+            report((std::string("block ") + chain).c_str(), t0, sink);
+        }
     }
+    return 0;
+}
 
-    auto service_uuid = notify_pair->first;
-    auto char_uuid = notify_pair->second;
+// Solves/s of BruteForce_16x2Solver::update() (one dynamic grid scan each,
+// plus a static one after quiet frames) for a few grid steps over the default
+// volume, on one thread and on all of them, and with the coarse-to-fine
+// pyramid. The input is a point source wandering over the pad. Then the
+// pyramid against the full scan and both against the simulator's truth.
+static int run_bench_solver(const Args& args) {
+    const auto sens = hub::BruteForce_16x2Solver::sensor_positions();
+    const int hw = (int)std::max(1u, std::thread::hardware_concurrency());
+    std::printf("solver bench: BruteForce_16x2, avx2/fma %s, %d hardware threads\n",
+                hub::BruteForce_16x2Solver::simd_available() ? "available" : "not available", hw);
+
+    for (double step : {0.02, 0.01, 0.005, 0.0025, 0.001}) {
+        hub::BruteForce_16x2Solver solver;
+        solver.set_grid(-0.06, 0.06, -0.06, 0.06, 0.01, 0.10, step);
+        const size_t ng = solver.grid_size();
+        const size_t updates = std::max<size_t>(20, (size_t)(3e7 / (double)ng));
+
+        for (int run = 0; run < (hw > 1 ? 4 : 2) + 1; ++run) {
+            const bool pyr = run == (hw > 1 ? 4 : 2);
+            const int simd = pyr ? 0 : run & 1;
+            const int threads = run < 2 || pyr ? 1 : hw;
+            if (simd && !hub::BruteForce_16x2Solver::simd_available()) continue;
+            solver.set_simd(simd != 0);
+            solver.set_threads(threads);
+            solver.set_pyramid(pyr);
+            solver.reset();
+            std::vector<float> v(hub::BruteForce_16x2Solver::NSENS);
+            double sink = 0.0;
+            uint64_t t0 = now_ns();
+            for (size_t i = 0; i < updates; ++i) {
+                const double a = (double)i * 0.01;
+                const double x = 0.03 * std::sin(a), y = 0.03 * std::cos(1.3 * a), z = 0.04;
+                for (size_t j = 0; j < v.size(); ++j) {
+                    const double dx = x - sens[j].x, dy = y - sens[j].y, dz = z - sens[j].z;
+                    v[j] = (float)(0.01 / std::sqrt(dx * dx + dy * dy + dz * dz));
+                }
+                sink += solver.update(v).x;
+            }
+            const double s = (double)(now_ns() - t0) * 1e-9;
+            if (pyr) {
+                std::printf("  grid %7zu  pyramid L%d %10.0f solves/s  %7zu points/solve  (%g)\n", ng,
+                            solver.pyramid_levels(), (double)updates / s, solver.last_evals(), sink);
+                continue;
+            }
+            std::printf("  grid %7zu  %-6s %2d thr %10.0f solves/s  %7.1f Mpoints/s  (%g)\n", ng,
+                        simd ? "avx2" : "scalar", threads, (double)updates / s,
+                        (double)updates * (double)ng / s * 1e-6, sink);
+        }
+    }
 
-    std::cout << "Notify: service=" << service_uuid << " char=" << char_uuid << "\n";
+    // One period of the simulator's path, decoded like a live stream, through
+    // a full-scan and a pyramid solver side by side, both with the simulator's
+    // RC and no smoothing. Both use the scalar kernels, so "differ" (outputs
+    // not identical) means the pyramid missed the full scan's grid point. Once
+    // on a clean stream, once with the --sim_* noise, hum and drift. The
+    // difference fit does not follow motion below the grid step, so the truth
+    // columns show that limit rather than the pyramid's. Distances in mm.
+    hub::SimConfig noisy = args.sim_cfg;
+    noisy.loss = 0.0;
+    hub::SimConfig clean = noisy;
+    clean.noise_rms = 0.0;
+    clean.hum_amp = 0.0;
+    clean.drift_rms = 0.0;
+    for (const hub::SimConfig& sc : {clean, noisy}) {
+        hub::SensorArraySimulator sim;
+        sim.reset(sc);
+        hub::StreamDecoder dec;
+        dec.set_layout(hub::SensorArraySimulator::csv_layout());
+        dec.reset();
+        hub::FrameBlock frames, blk;
+        frames.n_ch = hub::BruteForce_16x2Solver::NSENS;
+        std::vector<hub::Vec3d> truth;
+        const size_t nframes = (size_t)std::ceil(sc.fs_hz / sc.path_hz);
+        std::string pkt;
+        while (truth.size() < nframes) {
+            pkt.clear();
+            const double t = sim.time_s();
+            const size_t n = sim.next_packet(pkt);
+            dec.decode(pkt, 0, blk);
+            for (size_t i = 0; i < blk.n_frames; ++i) std::copy(blk.row(i), blk.row(i) + blk.n_ch, frames.append(0));
+            for (size_t i = 0; i < n; ++i) truth.push_back(sim.position(t + (double)i / sc.fs_hz));
+        }
+        if (frames.n_frames != truth.size()) {
+            std::printf("simulator stream decoded %zu of %zu frames\n", frames.n_frames, truth.size());
+            return 1;
+        }
 
-    hub::LineFramer framer;
-    hub::CsvFloatParser parser;
+        std::printf("pyramid vs full scan: %zu simulator frames (noise %g, hum %g, drift %g)\n", frames.n_frames,
+                    sc.noise_rms, sc.hum_amp, sc.drift_rms);
+        const double rc = sc.rc_samples > 0.0 ? sc.rc_samples : 1e16;   // DC coupled: V2 - V1
+        for (double step : {0.005, 0.0025, 0.001}) {
+            for (int top_k : {1, 4, 16}) {
+                hub::BruteForce_16x2Solver full, pyr;
+                for (hub::BruteForce_16x2Solver* s : {&full, &pyr}) {
+                    s->set_grid(-0.06, 0.06, -0.06, 0.06, 0.01, 0.10, step);
+                    s->set_params(1e8, rc / 1e8, 1.0, 0.3);
+                }
+                full.set_simd(false);
+                pyr.set_simd(false);
+                pyr.set_pyramid(true, top_k);
+
+                size_t n = 0, differ = 0, evals = 0;
+                double max_d = 0.0, sum_d = 0.0, sq_full = 0.0, sq_pyr = 0.0, max_pyr = 0.0;
+                std::vector<float> v(hub::BruteForce_16x2Solver::NSENS);
+                for (size_t i = 0; i < frames.n_frames; ++i) {
+                    std::copy(frames.row(i), frames.row(i) + v.size(), v.begin());
+                    const hub::BruteForce_16x2Output a = full.update(v);
+                    const hub::BruteForce_16x2Output b = pyr.update(v);
+                    evals += pyr.last_evals();
+                    if (!a.has_pose || !b.has_pose) continue;
+                    const double d = std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) +
+                                               (a.z - b.z) * (a.z - b.z)) * 1e3;
+                    const hub::Vec3d& r = truth[i];
+                    const double e2 = (b.x - r.x) * (b.x - r.x) + (b.y - r.y) * (b.y - r.y) + (b.z - r.z) * (b.z - r.z);
+                    sq_full += (a.x - r.x) * (a.x - r.x) + (a.y - r.y) * (a.y - r.y) + (a.z - r.z) * (a.z - r.z);
+                    sq_pyr += e2;
+                    max_pyr = std::max(max_pyr, std::sqrt(e2) * 1e3);
+                    differ += d > 0.0 || a.err != b.err;
+                    max_d = std::max(max_d, d);
+                    sum_d += d;
+                    ++n;
+                }
+                if (n == 0) continue;
+                std::printf("  grid %7zu  L%d top %2d  %6zu points/solve  differ %5.1f%%  |pyr - full| mean %.3f"
+                            " max %.3f  vs truth: full rms %.2f  pyr rms %.2f max %.2f\n",
+                            full.grid_size(), pyr.pyramid_levels(), top_k, evals / frames.n_frames,
+                            100.0 * (double)differ / (double)n, sum_d / (double)n, max_d,
+                            std::sqrt(sq_full / (double)n) * 1e3, std::sqrt(sq_pyr / (double)n) * 1e3, max_pyr);
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    Args args = parse_args(argc, argv);
+    if (args.bench_parser) return run_bench_parser();
+    if (args.bench_pipeline) return run_bench_pipeline();
+    if (args.bench_solver) return run_bench_solver(args);
+    if (args.sim_pty) return run_sim_pty(args);
 
-    hub::Pipeline pipe;
     hub::PipelineConfig cfg;
     cfg.enable_ma = args.ma_on;
     cfg.ma_win = args.ma_win;
@@ -177,10 +766,18 @@ int main(int argc, char** argv) {
     cfg.fs_hz = args.fs;
     cfg.notch_f0 = args.notch_f0;
     cfg.notch_q = args.notch_q;
+    cfg.notch_harmonics = args.notch_harmonics;
     cfg.enable_bias = args.bias_on;
-    cfg.enable_model = args.model_on;
-    cfg.model_bias = args.model_bias;
-    pipe.set_config(cfg);
+    cfg.stages = args.chain;
+
+    {
+        hub::Pipeline probe;
+        probe.set_config(cfg);
+        if (probe.delay_frames() > 0.0) {
+            std::printf("Pipeline delay: %.1f frames (%.1f ms at %g Hz)\n", probe.delay_frames(),
+                        probe.delay_frames() / cfg.fs_hz * 1e3, cfg.fs_hz);
+        }
+    }
 
     std::optional<std::ofstream> csv;
     if (!args.csv_path.empty()) {
@@ -191,97 +788,150 @@ int main(int argc, char** argv) {
         }
     }
 
-    std::atomic<bool> want_bias_capture{false};
-    std::atomic<bool> quit{false};
+    if (args.resample) {
+        const bool sinc = args.resample_cfg.method == hub::ResampleMethod::Sinc;
+        std::printf("Resampling to %g Hz (%s)\n", args.resample_cfg.fs_hz, sinc ? "sinc" : "linear");
+    }
 
-    std::thread input_thread([&]() {
-        for (;;) {
-            int c = std::getc(stdin);
-            if (c == EOF) continue;
-            if (c == 'b' || c == 'B') want_bias_capture.store(true);
-            if (c == 'q' || c == 'Q') { quit.store(true); break; }
+    Ingest ingest(cfg, csv ? &*csv : nullptr, args.resample ? &args.resample_cfg : nullptr);
+    std::atomic<bool> quit{false};
+    std::atomic<bool> done{false};
+
+    // --- Source ---
+    hub::ReplayReader replay;
+    hub::SimulatorReader sim;
+    std::optional<SimpleBLE::Peripheral> chosen;
+    SimpleBLE::BluetoothUUID service_uuid;
+    SimpleBLE::BluetoothUUID char_uuid;
+
+    if (!args.replay_path.empty()) {
+        std::string err;
+        if (!replay.open(args.replay_path, args.replay, err)) {
+            std::cerr << "Replay: " << err << "\n";
+            return 1;
         }
-    });
-
-    std::vector<float> weights_loaded;
-    bool weights_pending = false;
-    if (!args.weights_csv.empty()) {
-        auto w = hub::load_weights_csv_1line(args.weights_csv);
-        if (w) {
-            weights_loaded = *w;
-            weights_pending = true;
-            std::cout << "Weights loaded: " << weights_loaded.size() << "\n";
-        } else {
-            std::cerr << "Weights load failed: " << args.weights_csv << "\n";
+        const bool recording = replay.format() == hub::ReplayFormat::Recording;
+        std::cout << "Replay: " << args.replay_path << (recording ? " (recording)" : " (raw)")
+                  << " speed=" << args.replay.speed << "\n";
+
+        ingest.start(recording ? hub::ReplayReader::recording_layout() : hub::CsvLayout{}, !recording);
+        replay.start(ingest.ring(), [&]() { ingest.wake(); }, [&]() { done.store(true); });
+    } else if (args.sim) {
+        const bool binary = args.sim_cfg.wire == hub::WireFormat::Binary;
+        std::cout << "Simulator: " << args.sim_cfg.fs_hz << " Hz, " << (binary ? "binary" : "CSV")
+                  << " speed=" << args.speed << "\n";
+
+        ingest.start(binary ? hub::CsvLayout{} : hub::SensorArraySimulator::csv_layout(), false);
+        sim.start(args.sim_cfg, args.speed, ingest.ring(), [&]() { ingest.wake(); });
+    } else {
+        if (!SimpleBLE::Adapter::bluetooth_enabled()) {
+            std::cerr << "Bluetooth not enabled or permission missing\n";
+            return 1;
         }
-    }
-
-    uint64_t t0 = now_ns();
-    std::atomic<uint64_t> frames_ok{0};
-    std::atomic<uint64_t> frames_bad{0};
-
-    chosen.notify(service_uuid, char_uuid, [&](SimpleBLE::ByteArray payload) {
-        if (quit.load()) return;
 
-        std::string chunk(payload.begin(), payload.end());
-        auto lines = framer.push(chunk);
+        auto adapters = SimpleBLE::Adapter::get_adapters();
+        if (adapters.empty()) {
+            std::cerr << "No adapters\n";
+            return 1;
+        }
+        auto adapter = adapters[0];
 
-        for (auto& line : lines) {
-            auto v = parser.parse_line(line);
-            if (!v) { frames_bad.fetch_add(1); continue; }
+        std::cout << "Adapter: " << adapter.identifier() << " " << adapter.address() << "\n";
 
-            if (pipe.config().enable_model && weights_pending) {
-                pipe.ensure_initialized(v->size());
-                if (weights_loaded.size() == v->size()) {
-                    pipe.set_model_weights(weights_loaded);
-                    weights_pending = false;
+        for (;;) {
+            adapter.scan_for(args.scan_ms);
+            auto results = adapter.scan_get_results();
+
+            int best_rssi = -32768;
+            for (auto& p : results) {
+                if (!starts_with(p.identifier(), args.prefix)) continue;
+                int rssi = p.rssi();
+                if (!chosen || rssi > best_rssi) {
+                    chosen = p;
+                    best_rssi = rssi;
                 }
             }
 
-            if (want_bias_capture.exchange(false)) {
-                pipe.ensure_initialized(v->size());
-                pipe.begin_bias_capture(args.bias_capture_frames);
-                std::cout << "Bias capture started: frames=" << args.bias_capture_frames << "\n";
-            }
+            if (chosen) break;
+            std::cout << "Scanning... no match yet\n";
+        }
 
-            uint64_t t = now_ns();
-            auto out = pipe.process(t, *v);
-            frames_ok.fetch_add(1);
+        std::cout << "Chosen: " << chosen->identifier() << " " << chosen->address() << " rssi=" << chosen->rssi() << "\n";
 
-            if (csv) {
-                double ts = (static_cast<double>(out.frame.t_ns - t0)) * 1e-9;
-                (*csv) << ts;
-                for (size_t i = 0; i < out.frame.x.size(); ++i) (*csv) << "," << out.frame.x[i];
-                if (out.model_valid) (*csv) << "," << out.model_out;
-                (*csv) << "\n";
-            }
+        chosen->connect();
+        std::cout << "Connected\n";
 
-            static thread_local uint64_t last_print = 0;
-            if (t - last_print > 200000000ull) {
-                last_print = t;
-                std::cout << "N=" << out.frame.x.size()
-                          << " ok=" << frames_ok.load()
-                          << " bad=" << frames_bad.load();
+        auto notify_pair = pick_first_notify_char(*chosen);
+        if (!notify_pair) {
+            std::cerr << "No notify characteristic found\n";
+            return 1;
+        }
 
-                if (pipe.bias_capturing()) std::cout << " bias=capturing";
-                else if (pipe.bias_has()) std::cout << " bias=on";
+        service_uuid = notify_pair->first;
+        char_uuid = notify_pair->second;
 
-                if (out.model_valid) std::cout << " y=" << out.model_out;
-                std::cout << "\n";
-            }
-        }
-    });
+        std::cout << "Notify: service=" << service_uuid << " char=" << char_uuid << "\n";
 
-    std::cout << "Running. keys: b=bias capture, q=quit\n";
+        ingest.start(hub::CsvLayout{}, false);
+        chosen->notify(service_uuid, char_uuid, [&](SimpleBLE::ByteArray payload) {
+            if (quit.load()) return;
+            ingest.ring().write(payload.data(), payload.size());
+            ingest.wake();
+        });
 
-    while (!quit.load()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
     }
 
-    chosen.unsubscribe(service_uuid, char_uuid);
-    chosen.disconnect();
+    std::cout << "Running. keys: b=bias capture, q=quit\n";
 
-    if (input_thread.joinable()) input_thread.join();
+    std::thread([&]() {
+        for (;;) {
+            int c = std::getc(stdin);
+            if (c == EOF) break;
+            if (c == 'b' || c == 'B') {
+                ingest.request_bias_capture(args.bias_capture_frames);
+                std::cout << "Bias capture started: frames=" << args.bias_capture_frames << "\n";
+            }
+            if (c == 'q' || c == 'Q') { quit.store(true); break; }
+        }
+    }).detach();
+
+    // --- Run, report once per second ---
+    const uint64_t t0 = now_ns();
+    uint64_t last_t = t0;
+    uint64_t last_frames = 0;
+    uint64_t last_bytes = 0;
+
+    while (!quit.load() && !done.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        uint64_t t = now_ns();
+        if (args.seconds > 0.0 && (double)(t - t0) * 1e-9 >= args.seconds) break;
+        if (t - last_t < 1000000000ULL) continue;
+
+        uint64_t f = ingest.frames();
+        uint64_t b = ingest.bytes();
+        print_report("last 1 s:", ingest, f - last_frames, b - last_bytes, (double)(t - last_t) * 1e-9);
+        last_t = t;
+        last_frames = f;
+        last_bytes = b;
+    }
+
+    if (chosen) {
+        try { chosen->unsubscribe(service_uuid, char_uuid); } catch (...) {}
+        try { chosen->disconnect(); } catch (...) {}
+    }
+    replay.close();
+    sim.close();
+    ingest.drain_and_stop();
+
+    // Replay "as fast as possible" makes this the sustainable throughput of
+    // decoding + pipeline on this machine.
+    print_report("total:", ingest, ingest.frames(), ingest.bytes(), (double)(now_ns() - t0) * 1e-9);
+
+    if (args.sim) {
+        std::printf("sim: frames=%llu dropped=%llu (decoder lost=%llu)\n",
+                    (unsigned long long)sim.frames(), (unsigned long long)sim.dropped_frames(),
+                    (unsigned long long)ingest.lost());
+    }
 
     std::cout << "Done\n";
     return 0;
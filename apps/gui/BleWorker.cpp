@@ -1,8 +1,10 @@
 #include "BleWorker.h"
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <cstring>
-#include <QByteArray>
+#include <QFileInfo>
 #include <QMetaObject>
 
 static inline uint64_t now_ns() {
@@ -49,8 +51,41 @@ void BleWorker::resetStreamStatsLocked() {
     st_last1s_ts_.clear();
 }
 
+void BleWorker::resetIngest(const hub::CsvLayout& layout, bool lineSync) {
+    decoder_.set_layout(layout);
+    decoder_.set_line_sync(lineSync);
+    decoder_.reset();
+}
+
+void BleWorker::beginStream(const hub::CsvLayout& layout, bool lineSync) {
+    resetIngest(layout, lineSync);
+    stream_t0_ns_.store(now_ns());
+
+    {
+        QMutexLocker lk(&pipeMu_);
+        pipe_.reset();
+        pipe_.set_config(cfg_);
+        decim_.configure(0, decim_.factor(), decim_.taps());
+        resampler_.reset();
+        spec_.reset();
+        specEmitNs_ = 0;
+        specSent_ = 0;
+        lastBiasHas_ = pipe_.bias_has();
+        lastBiasCapturing_ = pipe_.bias_capturing();
+        resetStreamStatsLocked();
+    }
+
+    emit biasStateChanged(lastBiasHas_, lastBiasCapturing_);
+    emit streamStats(0, 0.0, 0, 0.0);
+
+    n_ch_.store(0);
+    ok_.store(0);
+    bad_.store(0);
+}
+
 void BleWorker::startAuto(QString prefix) {
     prefix_ = prefix;
+    autoScan_ = true;
 
     if (!adapter_) {
         emit statusText("No Bluetooth adapter (Serial only)");
@@ -135,6 +170,15 @@ void BleWorker::scanLoop() {
             // ignore
         }
 
+        // --- Simulated pads (no hardware needed; two so DeviceHub can merge) ---
+        for (int i = 0; i < 2; ++i) {
+            DeviceInfo d;
+            d.kind = DeviceKind::Simulator;
+            d.name = QString("Simulated 16-ch pad %1").arg(i + 1);
+            d.address = QString("sim:%1").arg(i);
+            list.push_back(d);
+        }
+
         {
             QMutexLocker lk(&scanMu_);
             lastScan_ = list;
@@ -152,59 +196,121 @@ void BleWorker::serialConnect(const QString& portName) {
         return;
     }
 
-    if (!serial_) {
-        serial_ = new QSerialPort(this);
-        connect(serial_, &QSerialPort::readyRead, this, &BleWorker::onSerialReadyRead);
-        connect(serial_, &QSerialPort::errorOccurred, this, &BleWorker::onSerialError);
-    } else {
-        if (serial_->isOpen()) serial_->close();
+    std::string err;
+    if (!serial_.open(portName.toStdString(), serialCfg_, err)) {
+        emit statusText(QString("Connect failed: Serial open: %1").arg(QString::fromStdString(err)));
+        return;
     }
 
-    serialPort_ = portName;
+    // Serial ports often start streaming mid-line when the port is opened.
+    beginStream(csvLayout_, true);
+
+    linkType_.store(2);
+    connected_.store(true);
+
+    startIngest();
+
+    serial_.start(ingest_,
+        [this]() {
+            if (ingestIdle_.load(std::memory_order_relaxed)) ingestWake_.notify_one();
+        },
+        [this](const std::string& e) {
+            // Unplug / fatal read error, reported from the reader thread.
+            if (quitting_.load()) return;
+            emit statusText(QString("Serial error: %1").arg(QString::fromStdString(e)));
+            QMetaObject::invokeMethod(this, [this]() {
+                if (quitting_.load()) return;
+                disconnectDevice();
+            }, Qt::QueuedConnection);
+        });
+}
+
+void BleWorker::serialDisconnect() {
+    serial_.close();
+}
 
-    serial_->setPortName(portName);
-    serial_->setBaudRate(QSerialPort::Baud115200);
-    serial_->setDataBits(QSerialPort::Data8);
-    serial_->setParity(QSerialPort::NoParity);
-    serial_->setStopBits(QSerialPort::OneStop);
-    serial_->setFlowControl(QSerialPort::NoFlowControl);
+void BleWorker::startReplay(QString path, hub::ReplayConfig cfg) {
+    if (connected_.load()) disconnectDevice();
 
-    if (!serial_->open(QIODevice::ReadOnly)) {
-        emit statusText(QString("Connect failed: Serial open: %1").arg(serial_->errorString()));
-        serialPort_.clear();
+    std::string err;
+    if (!replay_.open(path.toStdString(), cfg, err)) {
+        emit statusText(QString("Replay failed: %1").arg(QString::fromStdString(err)));
         return;
     }
 
-    serialSynced_.store(false);
-    framer_.clear();
-    stream_t0_ns_.store(now_ns());
+    // Recordings carry their own time column; raw captures may start mid-line.
+    const bool recording = replay_.format() == hub::ReplayFormat::Recording;
+    beginStream(recording ? hub::ReplayReader::recording_layout() : csvLayout_, !recording);
 
-    {
-        QMutexLocker lk(&pipeMu_);
-        pipe_.reset();
-        pipe_.set_config(cfg_);
-        lastBiasHas_ = pipe_.bias_has();
-        lastBiasCapturing_ = pipe_.bias_capturing();
-        resetStreamStatsLocked();
+    linkType_.store(3);
+    connected_.store(true);
+
+    startIngest();
+
+    replay_.start(ingest_,
+        [this]() {
+            if (ingestIdle_.load(std::memory_order_relaxed)) ingestWake_.notify_one();
+        },
+        [this]() {
+            // Stays "connected" so the final stats and plot remain visible.
+            if (quitting_.load()) return;
+            emit statusText("Replay finished");
+        });
+
+    emit connected(QFileInfo(path).fileName(), path);
+    emit statusText(recording ? "Replaying recording" : "Replaying raw capture");
+}
+
+void BleWorker::replayDisconnect() {
+    replay_.close();
+}
+
+void BleWorker::simConnect(const DeviceInfo& target) {
+    if (connected_.load() && linkType_.load() == 4 && connectedSim_ == target.address) {
+        emit statusText("Already connected");
+        return;
     }
+    if (connected_.load()) disconnectDevice();
 
-    emit biasStateChanged(lastBiasHas_, lastBiasCapturing_);
-    emit streamStats(0, 0.0, 0, 0.0);
+    // Each simulated pad gets its own noise.
+    hub::SimConfig cfg = simCfg_;
+    cfg.seed += (uint32_t)target.address.section(':', 1).toUInt();
 
-    n_ch_.store(0);
-    ok_.store(0);
-    bad_.store(0);
+    beginStream(cfg.wire == hub::WireFormat::Binary ? csvLayout_ : hub::SensorArraySimulator::csv_layout(), false);
 
-    linkType_.store(2);
+    linkType_.store(4);
     connected_.store(true);
+    connectedSim_ = target.address;
+
+    startIngest();
+
+    sim_.start(cfg, 1.0, ingest_, [this]() {
+        if (ingestIdle_.load(std::memory_order_relaxed)) ingestWake_.notify_one();
+    });
+
+    emit connected(target.name, target.address);
+    emit statusText("Connected");
 }
 
-void BleWorker::serialDisconnect() {
-    if (serial_) {
-        if (serial_->isOpen()) serial_->close();
+bool BleWorker::deviceAt(int index, DeviceInfo& info, std::optional<SimpleBLE::Peripheral>& peripheral) {
+    {
+        QMutexLocker lk(&scanMu_);
+        if (index < 0 || index >= lastScan_.size()) return false;
+        info = lastScan_[index];
+    }
+
+    peripheral.reset();
+    if (info.kind == DeviceKind::Ble) {
+        QMutexLocker lk(&periphMu_);
+        for (auto& p : peripherals_) {
+            if (QString::fromStdString(p.address()) == info.address) {
+                peripheral = p;
+                break;
+            }
+        }
+        if (!peripheral) return false;
     }
-    serialPort_.clear();
-    serialSynced_.store(false);
+    return true;
 }
 
 void BleWorker::connectToIndex(int index) {
@@ -212,21 +318,25 @@ void BleWorker::connectToIndex(int index) {
     stopScanning();
 
     DeviceInfo target;
-    {
-        QMutexLocker lk(&scanMu_);
-        if (index < 0 || index >= lastScan_.size()) {
-            if (wasScanning) startScanning();
-            return;
-        }
-        target = lastScan_[index];
+    std::optional<SimpleBLE::Peripheral> p;
+    if (deviceAt(index, target, p)) connectDevice(target, p);
+
+    // 스캔은 항상 유지
+    if (wasScanning) startScanning();
+}
+
+void BleWorker::connectDevice(DeviceInfo target, std::optional<SimpleBLE::Peripheral> peripheral) {
+    if (target.kind == DeviceKind::Simulator) {
+        simConnect(target);
+        return;
     }
 
     // --- Serial ---
     if (target.kind == DeviceKind::Serial) {
         // ✅ 같은 장치 재클릭으로 disconnect 토글하지 않음 (아무 것도 안 함)
-        if (connected_.load() && linkType_.load() == 2 && serial_ && serial_->isOpen() && serialPort_ == target.address) {
+        if (connected_.load() && linkType_.load() == 2 && serial_.is_open() &&
+            QString::fromStdString(serial_.port()) == target.address) {
             emit statusText("Already connected");
-            if (wasScanning) startScanning();
             return;
         }
 
@@ -239,33 +349,21 @@ void BleWorker::connectToIndex(int index) {
             emit connected(target.name, target.address);
             emit statusText("Connected");
         }
-
-        if (wasScanning) startScanning();
         return;
     }
 
     // --- BLE ---
-    if (!adapter_) {
-        emit statusText("No Bluetooth adapter");
-        if (wasScanning) startScanning();
+    if (!peripheral) {
+        emit statusText("Connect failed: device not found");
         return;
     }
 
-    SimpleBLE::Peripheral p;
-    {
-        QMutexLocker lk(&periphMu_);
-        if (index < 0 || index >= (int)peripherals_.size()) {
-            if (wasScanning) startScanning();
-            return;
-        }
-        p = peripherals_[(size_t)index];
-    }
+    SimpleBLE::Peripheral p = *peripheral;
 
     try {
         // ✅ 같은 장치 재클릭으로 disconnect 토글하지 않음 (아무 것도 안 함)
         if (connected_.load() && linkType_.load() == 1 && active_ && active_->address() == p.address()) {
             emit statusText("Already connected");
-            if (wasScanning) startScanning();
             return;
         }
 
@@ -279,7 +377,6 @@ void BleWorker::connectToIndex(int index) {
         if (!pair) {
             p.disconnect();
             emit statusText("No notify characteristic");
-            if (wasScanning) startScanning();
             return;
         }
 
@@ -298,28 +395,12 @@ void BleWorker::connectToIndex(int index) {
             });
         } catch (...) {}
 
-        framer_.clear();
-        stream_t0_ns_.store(now_ns());
-
-        {
-            QMutexLocker lk(&pipeMu_);
-            pipe_.reset();
-            pipe_.set_config(cfg_);
-            lastBiasHas_ = pipe_.bias_has();
-            lastBiasCapturing_ = pipe_.bias_capturing();
-            resetStreamStatsLocked();
-        }
-
-        emit biasStateChanged(lastBiasHas_, lastBiasCapturing_);
-        emit streamStats(0, 0.0, 0, 0.0);
-
-        n_ch_.store(0);
-        ok_.store(0);
-        bad_.store(0);
+        beginStream(csvLayout_, false);
 
         linkType_.store(1);
         connected_.store(true);
 
+        startIngest();
         notifyStart();
 
         emit connected(QString::fromStdString(p.identifier()), QString::fromStdString(p.address()));
@@ -327,9 +408,6 @@ void BleWorker::connectToIndex(int index) {
     } catch (...) {
         emit statusText("Connect failed");
     }
-
-    // 스캔은 항상 유지
-    if (wasScanning) startScanning();
 }
 
 void BleWorker::disconnectDevice() {
@@ -347,10 +425,17 @@ void BleWorker::disconnectDevice() {
         chr_.reset();
     } else if (lt == 2) {
         serialDisconnect();
+    } else if (lt == 3) {
+        replayDisconnect();
+    } else if (lt == 4) {
+        sim_.close();
+        connectedSim_.clear();
     }
 
+    stopIngest();
+
     stream_t0_ns_.store(0);
-    framer_.clear();
+    resetIngest(csvLayout_, false);
 
     stopCsv();
 
@@ -367,8 +452,8 @@ void BleWorker::disconnectDevice() {
     emit disconnected();
     emit statusText("Scanning...");
 
-    // 스캔이 꺼져있을 수도 있으니 보장
-    if (!scanning_.load() && !quitting_.load()) startScanning();
+    // 스캔이 꺼져있을 수도 있으니 보장 (scanner only; hub sessions never scan)
+    if (autoScan_ && !scanning_.load() && !quitting_.load()) startScanning();
 }
 
 void BleWorker::notifyStart() {
@@ -378,8 +463,8 @@ void BleWorker::notifyStart() {
         if (!connected_.load()) return;
         if (linkType_.load() != 1) return;
 
-        std::string chunk(payload.begin(), payload.end());
-        this->processChunk(std::string_view(chunk));
+        // Only copy bytes in; framing/parsing/pipeline run on the ingest thread.
+        this->pushIngest(reinterpret_cast<const char*>(payload.data()), payload.size());
     });
 }
 
@@ -388,65 +473,40 @@ void BleWorker::notifyStop() {
     active_->unsubscribe(*svc_, *chr_);
 }
 
-void BleWorker::onSerialReadyRead() {
-    if (!connected_.load()) return;
-    if (linkType_.load() != 2) return;
-    if (!serial_) return;
-
-    QByteArray data = serial_->readAll();
-    if (data.isEmpty()) return;
-
-    // Serial ports often start streaming mid-line when you open the port.
-    // If we feed that first partial line into the CSV parser, it can lock
-    // the channel count incorrectly (e.g., 10 instead of 16) and the plot
-    // may stay empty afterwards. To avoid this, discard everything until
-    // the next newline once per connect.
-    if (!serialSynced_.load()) {
-        int i_n = data.indexOf('\n');
-        int i_r = data.indexOf('\r');
-
-        int i = -1;
-        if (i_n >= 0 && i_r >= 0) i = (i_n < i_r) ? i_n : i_r;
-        else if (i_n >= 0) i = i_n;
-        else i = i_r;
-
-        if (i < 0) {
-            // Still syncing: drop this chunk.
-            return;
-        }
-
-        int adv = 1;
-        if (data.at(i) == '\r' && (i + 1) < data.size() && data.at(i + 1) == '\n') adv = 2;
-
-        data = data.mid(i + adv);
-        serialSynced_.store(true);
-
-        if (data.isEmpty()) return;
-    }
-
-    std::string chunk(data.constData(), (size_t)data.size());
-    processChunk(std::string_view(chunk));
+void BleWorker::startIngest() {
+    stopIngest();
+    ingest_.reset();
+    ingestRun_.store(true);
+    ingestThread_ = std::thread([this]() { this->ingestLoop(); });
 }
 
-void BleWorker::onSerialError(QSerialPort::SerialPortError error) {
-    if (error == QSerialPort::NoError) return;
-    if (!connected_.load()) return;
-    if (linkType_.load() != 2) return;
-    if (quitting_.load()) return;
-    if (!serial_) return;
+void BleWorker::stopIngest() {
+    ingestRun_.store(false);
+    ingestWake_.notify_one();
+    if (ingestThread_.joinable()) ingestThread_.join();
+}
 
-    // unplug / fatal errors
-    if (error == QSerialPort::ResourceError ||
-        error == QSerialPort::DeviceNotFoundError ||
-        error == QSerialPort::PermissionError ||
-        error == QSerialPort::OpenError) {
+void BleWorker::pushIngest(const char* data, size_t n) {
+    ingest_.write(data, n);
+    if (ingestIdle_.load(std::memory_order_relaxed)) ingestWake_.notify_one();
+}
 
-        emit statusText(QString("Serial error: %1").arg(serial_->errorString()));
+void BleWorker::ingestLoop() {
+    while (ingestRun_.load()) {
+        const char* p = nullptr;
+        size_t n = ingest_.read_span(p);
+        if (n > 0) {
+            processChunk(std::string_view(p, n));
+            ingest_.consume(n);
+            continue;
+        }
 
-        QMetaObject::invokeMethod(this, [this]() {
-            if (quitting_.load()) return;
-            disconnectDevice();
-        }, Qt::QueuedConnection);
+        // Producers only notify while we are idle; the timeout covers the race
+        // between the empty check above and setting the flag.
+        std::unique_lock<std::mutex> lk(ingestWakeMu_);
+        ingestIdle_.store(true);
+        ingestWake_.wait_for(lk, std::chrono::milliseconds(2));
+        ingestIdle_.store(false);
     }
 }
 
@@ -456,129 +516,257 @@ void BleWorker::processChunk(std::string_view chunk) {
     uint64_t stream_t0 = stream_t0_ns_.load();
     if (stream_t0 == 0) stream_t0 = now_ns();
 
-    auto lines = framer_.push(chunk);
+    uint64_t t = now_ns();
+
+    block_.n_ch = n_ch_.load();
 
-    for (auto& line : lines) {
-        auto v = parser_.parse_line(line);
-        if (!v) { bad_.fetch_add(1); continue; }
+    size_t nbad = decoder_.decode(chunk, t, block_);
+    if (nbad) bad_.fetch_add(nbad);
 
-        size_t n = v->size();
+    if (decoder_.take_wire_detected()) {
+        emit statusText(decoder_.wire() == hub::WireFormat::Binary ? "Stream: binary" : "Stream: CSV");
+    }
 
-        if (n_ch_.load() == 0) {
-            n_ch_.store(n);
-            QMutexLocker lk(&pipeMu_);
-            pipe_.ensure_initialized(n);
-            lastBiasHas_ = pipe_.bias_has();
-            lastBiasCapturing_ = pipe_.bias_capturing();
-            resetStreamStatsLocked();
-            emit biasStateChanged(lastBiasHas_, lastBiasCapturing_);
-            emit streamStats(0, 0.0, 0, 0.0);
+    if (block_.n_frames == 0) return;
+
+    bool resample = false;
+    {
+        QMutexLocker lk(&pipeMu_);
+        resample = resampleOn_;
+        if (resample) {
+            resampled_.clear();
+            resampler_.process(block_, resampled_);
         }
+    }
+    if (!resample) {
+        processBlock(block_, stream_t0);
+    } else if (resampled_.n_frames > 0) {
+        processBlock(resampled_, stream_t0);
+    }
+}
+
+void BleWorker::processBlock(hub::FrameBlock& blk, uint64_t stream_t0) {
+    const size_t n = blk.n_ch;
+    const size_t nf = blk.n_frames;
+
+    if (n_ch_.load() == 0) {
+        n_ch_.store(n);
+        QMutexLocker lk(&pipeMu_);
+        pipe_.ensure_initialized(n);
+        lastBiasHas_ = pipe_.bias_has();
+        lastBiasCapturing_ = pipe_.bias_capturing();
+        resetStreamStatsLocked();
+        emit biasStateChanged(lastBiasHas_, lastBiasCapturing_);
+        emit streamStats(0, 0.0, 0, 0.0);
+    }
 
-        if (n_ch_.load() != n) { bad_.fetch_add(1); continue; }
+    if (n_ch_.load() != n) { bad_.fetch_add(nf); return; }
 
-        uint64_t t = now_ns();
+    bool cap = false;
+    bool has = false;
+    bool emitBias = false;
+    bool emitStream = false;
+
+    qulonglong totalSamples = 0;
+    double totalTimeSec = 0.0;
+    qulonglong last1sSamples = 0;
+    double lastDtSec = 0.0;
+    double rateHz = 0.0;
+    uint64_t delayNs = 0;
+    bool decimated = false;
+    QVector<float> specPsd;
+    int specCh = 0;
+    double specBinHz = 0.0;
+    int specAvg = 0;
 
-        hub::PipelineOut out;
-        bool cap = false;
-        bool has = false;
-        bool emitBias = false;
-        bool emitStream = false;
+    {
+        // One lock per block instead of one per line.
+        QMutexLocker lk(&pipeMu_);
 
-        qulonglong totalSamples = 0;
-        double totalTimeSec = 0.0;
-        qulonglong last1sSamples = 0;
-        double lastDtSec = 0.0;
+        pipe_.process_block(blk);
 
-        {
-            QMutexLocker lk(&pipeMu_);
+        decimated = decim_.factor() > 1;
+        if (decimated) {
+            if (decim_.n_ch() != n) decim_.configure(n, decim_.factor(), decim_.taps());
+            display_.clear();
+            decim_.process(blk, display_);
+        }
 
-            out = pipe_.process(t, *v);
-            cap = pipe_.bias_capturing();
-            has = pipe_.bias_has();
+        double fs = decoder_.rate_hz() > 0.0 ? decoder_.rate_hz() : cfg_.fs_hz;
+        if (resampleOn_) fs = resampler_.config().fs_hz;
+        if (fs > 0.0) delayNs = (uint64_t)((pipe_.delay_frames() + decim_.delay()) / fs * 1e9);
 
-            if (cap != lastBiasCapturing_ || has != lastBiasHas_) {
-                lastBiasCapturing_ = cap;
-                lastBiasHas_ = has;
-                emitBias = true;
+        if (specOn_ && fs > 0.0) {
+            // Follow the rate estimate, with the same 1% hysteresis as the GUI.
+            if (spec_.n_ch() != n || std::fabs(spec_.config().fs_hz - fs) > 0.01 * fs) {
+                specCfg_.fs_hz = fs;
+                spec_.configure(n, specCfg_);
+                specSent_ = 0;
             }
+            spec_.push(blk);
+
+            const uint64_t tl = blk.t_ns[nf - 1];
+            if (spec_.segments() != specSent_ && (specEmitNs_ == 0 || tl - specEmitNs_ >= 100000000ULL)) {
+                specEmitNs_ = tl;
+                specSent_ = spec_.segments();
+                spec_.welch(specOut_);
+                specPsd.resize((int)specOut_.size());
+                std::copy(specOut_.begin(), specOut_.end(), specPsd.begin());
+                specCh = (int)n;
+                specBinHz = spec_.bin_hz();
+                specAvg = (int)spec_.averaged();
+            }
+        }
+
+        cap = pipe_.bias_capturing();
+        has = pipe_.bias_has();
 
+        if (cap != lastBiasCapturing_ || has != lastBiasHas_) {
+            lastBiasCapturing_ = cap;
+            lastBiasHas_ = has;
+            emitBias = true;
+        }
+
+        for (size_t i = 0; i < nf; ++i) {
+            uint64_t tn = blk.t_ns[i];
             st_total_samples_ += 1;
 
-            uint64_t tn = (uint64_t)out.frame.t_ns;
             if (st_first_ns_ == 0) st_first_ns_ = tn;
 
-            if (st_prev_ns_ != 0) st_last_dt_ns_ = tn - st_prev_ns_;
-            else st_last_dt_ns_ = 0;
+            // Frames of one chunk share a timestamp; keep the last real spacing.
+            if (st_prev_ns_ != 0 && tn > st_prev_ns_) st_last_dt_ns_ = tn - st_prev_ns_;
 
             st_prev_ns_ = tn;
             st_last_ns_ = tn;
 
             st_last1s_ts_.push_back(tn);
-            while (!st_last1s_ts_.empty() && (tn - st_last1s_ts_.front()) > 1000000000ULL) {
-                st_last1s_ts_.pop_front();
-            }
+        }
 
-            if (st_last_emit_ns_ == 0 || (tn - st_last_emit_ns_) >= 200000000ULL) {
-                st_last_emit_ns_ = tn;
-                emitStream = true;
+        uint64_t tn = st_last_ns_;
+        while (!st_last1s_ts_.empty() && (tn - st_last1s_ts_.front()) > 1000000000ULL) {
+            st_last1s_ts_.pop_front();
+        }
 
-                totalSamples = (qulonglong)st_total_samples_;
-                totalTimeSec = (st_last_ns_ > st_first_ns_) ? (double)(st_last_ns_ - st_first_ns_) * 1e-9 : 0.0;
-                last1sSamples = (qulonglong)st_last1s_ts_.size();
-                lastDtSec = (double)st_last_dt_ns_ * 1e-9;
-            }
+        if (st_last_emit_ns_ == 0 || (tn - st_last_emit_ns_) >= 200000000ULL) {
+            st_last_emit_ns_ = tn;
+            emitStream = true;
+
+            totalSamples = (qulonglong)st_total_samples_;
+            totalTimeSec = (st_last_ns_ > st_first_ns_) ? (double)(st_last_ns_ - st_first_ns_) * 1e-9 : 0.0;
+            last1sSamples = (qulonglong)st_last1s_ts_.size();
+            lastDtSec = (double)st_last_dt_ns_ * 1e-9;
+
+            rateHz = decoder_.rate_hz();
         }
+    }
 
-        if (emitBias) emit biasStateChanged(has, cap);
-        if (emitStream) emit streamStats(totalSamples, totalTimeSec, last1sSamples, lastDtSec);
+    if (emitBias) emit biasStateChanged(has, cap);
+    if (specCh > 0) emit spectrumReady(specPsd, specCh, specBinHz, specAvg);
+    if (emitStream) {
+        emit streamStats(totalSamples, totalTimeSec, last1sSamples, lastDtSec);
+        if (rateHz > 0.0) emit rateEstimated(rateHz);
+    }
 
-        ok_.fetch_add(1);
+    ok_.fetch_add(nf);
 
-        if (csvOn_.load()) {
-            QMutexLocker lk(&csvMu_);
-            if (csv_ && (*csv_)) {
-                if (!csvHeaderWritten_) {
-                    (*csv_) << "t";
-                    for (size_t i = 0; i < out.frame.x.size(); ++i) (*csv_) << ",ch" << i;
-                    (*csv_) << "\n";
-                    csvHeaderWritten_ = true;
-                }
-                uint64_t base = (csv_t0_ns_ ? csv_t0_ns_ : stream_t0);
-                double ts = (static_cast<double>(out.frame.t_ns - base)) * 1e-9;
+    if (csvOn_.load()) {
+        QMutexLocker lk(&csvMu_);
+        if (csv_ && (*csv_)) {
+            if (!csvHeaderWritten_) {
+                (*csv_) << "t";
+                for (size_t c = 0; c < n; ++c) (*csv_) << ",ch" << c;
+                (*csv_) << "\n";
+                csvHeaderWritten_ = true;
+            }
+            uint64_t base = (csv_t0_ns_ ? csv_t0_ns_ : stream_t0);
+            for (size_t i = 0; i < nf; ++i) {
+                const float* x = blk.row(i);
+                // Fixed microseconds: t is the replay clock, 6 significant
+                // digits would lose it after a few minutes.
+                char ts[32];
+                std::snprintf(ts, sizeof(ts), "%.6f", (static_cast<double>(blk.t_ns[i] - base)) * 1e-9);
                 (*csv_) << ts;
-                for (size_t i = 0; i < out.frame.x.size(); ++i) (*csv_) << "," << out.frame.x[i];
+                for (size_t c = 0; c < n; ++c) (*csv_) << "," << x[c];
                 (*csv_) << "\n";
             }
         }
+    }
 
-        QVector<float> qx;
-        qx.reserve((int)out.frame.x.size());
-        for (float f : out.frame.x) qx.push_back(f);
-
-        emit frameReady((qulonglong)out.frame.t_ns, qx, false, 0.0f);
+    // Plots and tracking get the (decimated) frames at the time the filtered
+    // sample belongs to; the CSV above keeps every frame and the arrival time.
+    const hub::FrameBlock& out = decimated ? display_ : blk;
+    for (size_t i = 0; i < out.n_frames; ++i) {
+        const float* x = out.row(i);
+        QVector<float> qx((int)n);
+        std::copy(x, x + n, qx.begin());
+        const uint64_t t = out.t_ns[i] > delayNs ? out.t_ns[i] - delayNs : 0;
+        emit frameReady((qulonglong)t, qx, false, 0.0f);
+    }
 
-        static thread_local uint64_t lastStats = 0;
-        if (t - lastStats > 500000000ULL) {
-            lastStats = t;
-            emit statsUpdated(ok_.load(), bad_.load());
-        }
+    uint64_t t = now_ns();
+    static thread_local uint64_t lastStats = 0;
+    if (t - lastStats > 500000000ULL) {
+        lastStats = t;
+        emit statsUpdated(ok_.load(), bad_.load(),
+                          (qulonglong)ingest_.overflow_bytes(), (qulonglong)ingest_.high_water(),
+                          (qulonglong)decoder_.lost());
     }
 }
 
 void BleWorker::setPipelineConfig(hub::PipelineConfig cfg) {
     bool cap = false;
     bool has = false;
+    double delay = 0.0;
     {
         QMutexLocker lk(&pipeMu_);
         cfg_ = cfg;
         pipe_.set_config(cfg_);
         cap = pipe_.bias_capturing();
         has = pipe_.bias_has();
+        delay = pipe_.delay_frames() + decim_.delay();
         lastBiasCapturing_ = cap;
         lastBiasHas_ = has;
     }
     emit biasStateChanged(has, cap);
+    emit pipelineDelay(delay);
+}
+
+void BleWorker::setDisplayDecimation(int factor, int taps) {
+    double delay = 0.0;
+    {
+        QMutexLocker lk(&pipeMu_);
+        decim_.configure(n_ch_.load(), (size_t)std::max(factor, 1), (size_t)std::max(taps, 0));
+        delay = pipe_.delay_frames() + decim_.delay();
+    }
+    emit pipelineDelay(delay);
+}
+
+void BleWorker::setResampling(bool on, hub::ResamplerConfig cfg) {
+    QMutexLocker lk(&pipeMu_);
+    resampleOn_ = on;
+    resampler_.configure(cfg);
+}
+
+void BleWorker::setSpectrum(bool on, hub::SpectrumConfig cfg) {
+    QMutexLocker lk(&pipeMu_);
+    specOn_ = on;
+    specCfg_ = cfg;
+    // Configured on the next block, once the channel count and rate are known.
+    spec_ = hub::SpectrumAnalyzer{};
+    specEmitNs_ = 0;
+    specSent_ = 0;
+}
+
+void BleWorker::setSerialConfig(hub::SerialConfig cfg) {
+    serialCfg_ = cfg;
+}
+
+void BleWorker::setCsvLayout(hub::CsvLayout layout) {
+    csvLayout_ = layout;
+}
+
+void BleWorker::setSimConfig(hub::SimConfig cfg) {
+    simCfg_ = cfg;
 }
 
 void BleWorker::startBiasCapture(int frames) {
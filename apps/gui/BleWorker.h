@@ -7,12 +7,13 @@
 #include <QMutex>
 #include <QMutexLocker>
 
-#include <QtSerialPort/QSerialPort>
 #include <QtSerialPort/QSerialPortInfo>
 
 #include <atomic>
+#include <condition_variable>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 #include <optional>
@@ -22,13 +23,22 @@
 
 #include <simpleble/SimpleBLE.h>
 
-#include "hub/Framer.h"
+#include "hub/Frame.h"
 #include "hub/Parser.h"
 #include "hub/Pipeline.h"
+#include "hub/ReplayReader.h"
+#include "hub/Resampler.h"
+#include "hub/SerialReader.h"
+#include "hub/Simulator.h"
+#include "hub/filters/Decimator.h"
+#include "hub/Spectrum.h"
+#include "hub/SpscRing.h"
+#include "hub/StreamDecoder.h"
 
 enum class DeviceKind : int {
     Ble = 0,
     Serial = 1,
+    Simulator = 2,
 };
 
 struct DeviceInfo {
@@ -44,12 +54,34 @@ public:
     explicit BleWorker(QObject* parent = nullptr);
     ~BleWorker();
 
+    // Entry `index` of the last scan, with its BLE peripheral. Thread-safe; used
+    // to hand a scanned device to another worker (DeviceHub sessions).
+    bool deviceAt(int index, DeviceInfo& info, std::optional<SimpleBLE::Peripheral>& peripheral);
+
 public slots:
     void startAuto(QString prefix);
     void connectToIndex(int index);
+    void connectDevice(DeviceInfo target, std::optional<SimpleBLE::Peripheral> peripheral);
     void disconnectDevice();
 
+    // Plays a recording or raw capture through the ingest path as if a device
+    // were connected.
+    void startReplay(QString path, hub::ReplayConfig cfg);
+
     void setPipelineConfig(hub::PipelineConfig cfg);
+    // Both apply to the next connect.
+    void setSerialConfig(hub::SerialConfig cfg);
+    void setCsvLayout(hub::CsvLayout layout);
+    void setSimConfig(hub::SimConfig cfg);   // applies to the next simulator connect
+    // Anti-aliased decimation of what frameReady carries (plot, tracking); the
+    // CSV keeps every frame. taps = 0 picks the default length.
+    void setDisplayDecimation(int factor, int taps);
+    // Resamples the decoded frames onto a uniform cfg.fs_hz grid before the
+    // pipeline, so filters see the rate they were designed for and devices
+    // at the same rate share timestamps.
+    void setResampling(bool on, hub::ResamplerConfig cfg);
+    // Welch PSD of the pipeline output; cfg.fs_hz is replaced by the stream rate.
+    void setSpectrum(bool on, hub::SpectrumConfig cfg);
     void startBiasCapture(int frames);
 
     void startCsv(QString path);
@@ -64,10 +96,22 @@ signals:
     void disconnected();
 
     void frameReady(qulonglong t_ns, QVector<float> x, bool modelValid, float modelOut);
-    void statsUpdated(qulonglong ok, qulonglong bad);
+    // overflowBytes: bytes dropped because the ingest ring was full.
+    // ringHighWater: peak ingest ring fill in bytes since connect.
+    // lost: samples missing according to the device counter / device time.
+    void statsUpdated(qulonglong ok, qulonglong bad, qulonglong overflowBytes, qulonglong ringHighWater,
+                      qulonglong lost);
 
     void biasStateChanged(bool hasBias, bool capturing);
     void streamStats(qulonglong totalSamples, double totalTimeSec, qulonglong last1sSamples, double lastDtSec);
+    // Sample rate from device time or host clock recovery; sent with streamStats once known.
+    void rateEstimated(double fsHz);
+    // Delay of the pipeline plus the display decimator, in input frames, sent
+    // on every config change. frameReady times are already moved back by it.
+    void pipelineDelay(double frames);
+    // Welch PSD (nCh x bins, channel-major, units^2/Hz) at most every 100 ms
+    // of stream while enabled by setSpectrum.
+    void spectrumReady(QVector<float> psd, int nCh, double binHz, int averaged);
 
 private:
     void startScanning();
@@ -76,21 +120,31 @@ private:
     void notifyStart();
     void notifyStop();
 
+    void resetIngest(const hub::CsvLayout& layout, bool lineSync);
+    void startIngest();
+    void stopIngest();
+    void pushIngest(const char* data, size_t n);
+    void ingestLoop();
+
     void processChunk(std::string_view chunk);
+    void processBlock(hub::FrameBlock& blk, uint64_t stream_t0);
 
     void serialConnect(const QString& portName);
     void serialDisconnect();
 
-    void resetStreamStatsLocked();
+    void replayDisconnect();
+    void simConnect(const DeviceInfo& target);
+
+    // Common part of every connect: fresh decoder, pipeline and counters.
+    void beginStream(const hub::CsvLayout& layout, bool lineSync);
 
-private slots:
-    void onSerialReadyRead();
-    void onSerialError(QSerialPort::SerialPortError error);
+    void resetStreamStatsLocked();
 
 private:
     std::atomic<bool> scanning_{false};
     std::atomic<bool> connected_{false};
     std::atomic<bool> quitting_{false};
+    bool autoScan_ = false;   // set by startAuto(); restarts scanning after disconnect
     std::thread scanThread_;
 
     QString prefix_{"Softionics"};
@@ -106,23 +160,46 @@ private:
     std::optional<SimpleBLE::BluetoothUUID> svc_;
     std::optional<SimpleBLE::BluetoothUUID> chr_;
 
-    std::atomic<int> linkType_{0}; // 0 none, 1 BLE, 2 Serial
+    std::atomic<int> linkType_{0}; // 0 none, 1 BLE, 2 Serial, 3 Replay, 4 Simulator
 
-    QSerialPort* serial_ = nullptr;
-    QString serialPort_;
+    // Reads on its own thread straight into ingest_ (no Qt event loop hop).
+    hub::SerialReader serial_;
+    hub::SerialConfig serialCfg_;
 
+    hub::ReplayReader replay_;
 
-    // Serial streams can start mid-line when the port is opened.
-    // We sync to the next newline before feeding data to the CSV framer/parser.
-    std::atomic<bool> serialSynced_{false};
+    hub::SimulatorReader sim_;
+    hub::SimConfig simCfg_;
+    QString connectedSim_;
 
     std::atomic<uint64_t> stream_t0_ns_{0};
 
-    hub::LineFramer framer_;
-    hub::CsvFloatParser parser_;
+    // Transport callbacks only copy bytes into ingest_; ingestThread_ drains it
+    // through framing/parsing/pipeline so a slow consumer never blocks the BLE stack.
+    hub::SpscByteRing ingest_{1u << 20};
+    std::thread ingestThread_;
+    std::atomic<bool> ingestRun_{false};
+    std::atomic<bool> ingestIdle_{false};
+    std::mutex ingestWakeMu_;
+    std::condition_variable ingestWake_;
+
+    hub::StreamDecoder decoder_;   // wire format, framing, parsing, t_ns
+    hub::CsvLayout csvLayout_;
+    hub::FrameBlock block_;     // lines of the current chunk
+    hub::Resampler resampler_;  // under pipeMu_
+    hub::FrameBlock resampled_; // grid frames of the current chunk
+    bool resampleOn_ = false;
 
     hub::Pipeline pipe_;
     hub::PipelineConfig cfg_;
+    hub::Decimator decim_;      // display branch; also under pipeMu_
+    hub::FrameBlock display_;   // decimated frames of the current block
+    hub::SpectrumAnalyzer spec_;    // under pipeMu_
+    hub::SpectrumConfig specCfg_;
+    bool specOn_ = false;
+    uint64_t specEmitNs_ = 0;
+    uint64_t specSent_ = 0;     // segments() at the last snapshot
+    std::vector<float> specOut_;
     QMutex pipeMu_;
 
     bool lastBiasHas_ = false;
@@ -0,0 +1,144 @@
+#include "DeviceHub.h"
+#include <QMetaObject>
+#include <algorithm>
+
+DeviceHub::DeviceHub(BleWorker* primary, QObject* parent) : QObject(parent), primary_(primary) {
+    connect(primary_, &BleWorker::frameReady, this, [this](qulonglong t_ns, QVector<float> x, bool, float) {
+        if (primaryLive_) onFrame(primarySrc_, t_ns, x);
+    });
+    connect(primary_, &BleWorker::connected, this, [this](QString, QString) {
+        if (primaryLive_) return;
+        primaryLive_ = true;
+        primarySrc_ = aligner_.add_source();
+        emit sessionsChanged();
+    });
+    connect(primary_, &BleWorker::disconnected, this, [this]() {
+        if (!primaryLive_) return;
+        primaryLive_ = false;
+        aligner_.remove_source(primarySrc_);
+        if (aligner_.active_sources() <= 1) emitAligned();
+        emit sessionsChanged();
+    });
+}
+
+DeviceHub::~DeviceHub() {
+    while (!sessions_.empty()) dropSession(sessions_.back().get());
+}
+
+void DeviceHub::addDevice(int scanIndex, WorkerFn setup) {
+    DeviceInfo info;
+    std::optional<SimpleBLE::Peripheral> peripheral;
+    if (!primary_->deviceAt(scanIndex, info, peripheral)) {
+        emit statusText("Device not available");
+        return;
+    }
+
+    // A session that never came up (failed connect) is replaced.
+    for (auto& s : sessions_) {
+        if (s->address != info.address) continue;
+        if (s->live) return;
+        dropSession(s.get());
+        break;
+    }
+
+    auto session = std::make_unique<Session>();
+    Session* s = session.get();
+    s->address = info.address;
+    s->name = info.name;
+    s->worker = new BleWorker();
+    s->thread = new QThread();
+    s->worker->moveToThread(s->thread);
+    s->thread->start();
+
+    connect(s->worker, &BleWorker::frameReady, this, [this, s](qulonglong t_ns, QVector<float> x, bool, float) {
+        if (s->live) onFrame(s->src, t_ns, x);
+    });
+    connect(s->worker, &BleWorker::connected, this, [this, s](QString name, QString) {
+        if (s->live) return;
+        s->live = true;
+        s->name = name;
+        s->src = aligner_.add_source();
+        emit sessionsChanged();
+    });
+    connect(s->worker, &BleWorker::disconnected, this, [this, s]() { dropSession(s); });
+    connect(s->worker, &BleWorker::statusText, this, [this, s](QString text) {
+        emit statusText(QString("%1: %2").arg(s->name, text));
+    });
+
+    sessions_.push_back(std::move(session));
+
+    QMetaObject::invokeMethod(s->worker, [w = s->worker, setup, info, peripheral]() {
+        if (setup) setup(w);
+        w->connectDevice(info, peripheral);
+    }, Qt::QueuedConnection);
+
+    emit sessionsChanged();
+}
+
+void DeviceHub::removeDevice(const QString& address) {
+    for (auto& s : sessions_) {
+        if (s->address == address) {
+            dropSession(s.get());
+            return;
+        }
+    }
+}
+
+bool DeviceHub::hasDevice(const QString& address) const {
+    for (const auto& s : sessions_) {
+        if (s->live && s->address == address) return true;
+    }
+    return false;
+}
+
+void DeviceHub::forEachWorker(WorkerFn fn) {
+    QMetaObject::invokeMethod(primary_, [w = primary_, fn]() { fn(w); }, Qt::QueuedConnection);
+    for (auto& s : sessions_) {
+        QMetaObject::invokeMethod(s->worker, [w = s->worker, fn]() { fn(w); }, Qt::QueuedConnection);
+    }
+}
+
+void DeviceHub::dropSession(Session* s) {
+    auto it = std::find_if(sessions_.begin(), sessions_.end(),
+                           [s](const std::unique_ptr<Session>& p) { return p.get() == s; });
+    if (it == sessions_.end()) return;
+
+    QObject::disconnect(s->worker, nullptr, this, nullptr);
+
+    if (s->live) {
+        s->live = false;
+        aligner_.remove_source(s->src);
+    }
+
+    QMetaObject::invokeMethod(s->worker, "disconnectDevice", Qt::BlockingQueuedConnection);
+    s->thread->quit();
+    s->thread->wait();
+    delete s->worker;
+    delete s->thread;
+
+    sessions_.erase(it);
+
+    // Back to a single device: release what was waiting for the others.
+    if (aligner_.active_sources() <= 1) emitAligned();
+
+    emit sessionsChanged();
+}
+
+void DeviceHub::onFrame(size_t src, qulonglong t_ns, const QVector<float>& x) {
+    // Single device: pass through untouched.
+    if (aligner_.active_sources() <= 1) {
+        emit frameReady(t_ns, x, false, 0.0f);
+        return;
+    }
+
+    aligner_.push(src, (uint64_t)t_ns, x.constData(), (size_t)x.size());
+    emitAligned();
+}
+
+void DeviceHub::emitAligned() {
+    while (aligner_.pop(merged_)) {
+        QVector<float> qx((int)merged_.x.size());
+        std::copy(merged_.x.begin(), merged_.x.end(), qx.begin());
+        emit frameReady((qulonglong)merged_.t_ns, qx, false, 0.0f);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef SOFTIONICS_GUI_DEVICEHUB_H
+#define SOFTIONICS_GUI_DEVICEHUB_H
+
+#include <QObject>
+#include <QThread>
+#include <QVector>
+#include <QString>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "BleWorker.h"
+#include "hub/Frame.h"
+#include "hub/StreamAligner.h"
+
+// Owns the concurrent device sessions. The primary worker (scanner) is owned by
+// MainWindow; every additional device gets its own BleWorker on its own thread,
+// so framing, parsing and the pipeline of each device run in parallel.
+//
+// frameReady() is the merged stream: with one live device it passes frames
+// through unchanged, with several it emits time-aligned frames whose channels
+// are the devices' channels concatenated in session order (hub::StreamAligner).
+class DeviceHub : public QObject {
+    Q_OBJECT
+public:
+    using WorkerFn = std::function<void(BleWorker*)>;
+
+    explicit DeviceHub(BleWorker* primary, QObject* parent = nullptr);
+    ~DeviceHub();
+
+    // Opens an extra session for entry `scanIndex` of the primary's scan list.
+    // `setup` runs on the new worker's thread before it connects.
+    void addDevice(int scanIndex, WorkerFn setup);
+    void removeDevice(const QString& address);
+    bool hasDevice(const QString& address) const;
+
+    // Queues fn on every worker (primary included), each on its own thread.
+    void forEachWorker(WorkerFn fn);
+
+signals:
+    void frameReady(qulonglong t_ns, QVector<float> x, bool modelValid, float modelOut);
+    void statusText(QString text);
+    void sessionsChanged();
+
+private:
+    struct Session {
+        BleWorker* worker = nullptr;
+        QThread* thread = nullptr;
+        QString address;
+        QString name;
+        size_t src = 0;
+        bool live = false;
+    };
+
+    void onFrame(size_t src, qulonglong t_ns, const QVector<float>& x);
+    void emitAligned();
+    void dropSession(Session* s);
+
+    BleWorker* primary_ = nullptr;
+    size_t primarySrc_ = 0;
+    bool primaryLive_ = false;
+
+    std::vector<std::unique_ptr<Session>> sessions_;
+
+    hub::StreamAligner aligner_;
+    hub::Frame merged_;
+};
+
+#endif
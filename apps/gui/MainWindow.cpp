@@ -1,11 +1,14 @@
 #include "MainWindow.h"
 #include "PositionTrackingWindow.h"
+#include "SpectrumWindow.h"
 
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QSplitter>
 #include <QGroupBox>
+#include <QIntValidator>
 #include <QFileDialog>
+#include <QMenu>
 #include <QFont>
 #include <QPainter>
 #include <QAbstractItemView>
@@ -54,10 +57,20 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     connect(worker_, &BleWorker::statusText, this, &MainWindow::onStatus);
     connect(worker_, &BleWorker::connected, this, &MainWindow::onConnected);
     connect(worker_, &BleWorker::disconnected, this, &MainWindow::onDisconnected);
-    connect(worker_, &BleWorker::frameReady, this, &MainWindow::onFrame);
+
+    hub_ = new DeviceHub(worker_, this);
+    connect(hub_, &DeviceHub::frameReady, this, &MainWindow::onFrame);
+    connect(hub_, &DeviceHub::statusText, this, &MainWindow::onStatus);
+    connect(hub_, &DeviceHub::sessionsChanged, this, [this]() {
+        clearPlotData();
+        updateDeviceListDecor();
+    });
+
     connect(worker_, &BleWorker::statsUpdated, this, &MainWindow::onStats);
     connect(worker_, &BleWorker::biasStateChanged, this, &MainWindow::onBiasState);
     connect(worker_, &BleWorker::streamStats, this, &MainWindow::onStreamStats);
+    connect(worker_, &BleWorker::rateEstimated, this, &MainWindow::onRateEstimated);
+    connect(worker_, &BleWorker::pipelineDelay, this, &MainWindow::onPipelineDelay);
 
     buildUi();
 
@@ -92,6 +105,13 @@ MainWindow::~MainWindow() {
         ptWin_ = nullptr;
     }
 
+    // It talks to worker_, which goes away below.
+    delete specWin_;
+    specWin_ = nullptr;
+
+    delete hub_;
+    hub_ = nullptr;
+
     if (worker_) {
         QMetaObject::invokeMethod(worker_, "disconnectDevice", Qt::BlockingQueuedConnection);
     }
@@ -113,7 +133,7 @@ void MainWindow::buildUi() {
     devPanel->setMinimumWidth(280);
     auto* devL = new QVBoxLayout(devPanel);
 
-    auto* devTitle = new QLabel("Devices (BLE / COM, click to connect)", devPanel);
+    auto* devTitle = new QLabel("Devices (BLE / COM, click to connect, right-click to add)", devPanel);
     QFont titleFont = devTitle->font();
     titleFont.setBold(true);
     devTitle->setFont(titleFont);
@@ -124,6 +144,8 @@ void MainWindow::buildUi() {
     list_->setMouseTracking(true);
     list_->setItemDelegate(new DeviceItemDelegate(list_));
     connect(list_, &QListWidget::itemClicked, this, &MainWindow::onDeviceClicked);
+    list_->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(list_, &QListWidget::customContextMenuRequested, this, &MainWindow::onDeviceContextMenu);
 
     status_ = new QLabel("Scanning...", devPanel);
     status_->setObjectName("StatusLabel");
@@ -194,6 +216,14 @@ void MainWindow::buildUi() {
     ptL->addWidget(btn_pt_);
     ctrlL->addWidget(gPT);
 
+    auto* gSpec = new QGroupBox("Spectrum", ctrlPanel);
+    auto* specL = new QVBoxLayout(gSpec);
+    btn_spec_ = new QPushButton("Open Spectrum Window", gSpec);
+    btn_spec_->setToolTip("Welch PSD and spectrogram of the filtered stream (primary device)");
+    connect(btn_spec_, &QPushButton::clicked, this, &MainWindow::onOpenSpectrum);
+    specL->addWidget(btn_spec_);
+    ctrlL->addWidget(gSpec);
+
     auto* gPlot = new QGroupBox("Plot", ctrlPanel);
     auto* pL = new QVBoxLayout(gPlot);
 
@@ -220,6 +250,18 @@ void MainWindow::buildUi() {
         sp_yabs_->setEnabled(!on);
     });
 
+    // Decimates the frames sent to the plot and tracking; recording keeps all.
+    sp_decim_ = new QSpinBox(gPlot);
+    sp_decim_->setRange(1, 64);
+    sp_decim_->setValue(1);
+    sp_decim_->setToolTip("Plot and tracking get every N-th frame, anti-alias filtered;\n"
+                          "CSV recording keeps the full rate");
+    sp_decim_taps_ = new QSpinBox(gPlot);
+    sp_decim_taps_->setRange(0, 4097);
+    sp_decim_taps_->setValue(0);
+    sp_decim_taps_->setSpecialValueText("auto");
+    sp_decim_taps_->setToolTip("Anti-alias FIR length (auto = 20 * N + 1)");
+
     auto* row1 = new QWidget(gPlot);
     auto* r1 = new QHBoxLayout(row1);
     r1->addWidget(new QLabel("X window (s)"));
@@ -239,6 +281,14 @@ void MainWindow::buildUi() {
     r3->addWidget(sp_yabs_);
     pL->addWidget(row3);
 
+    auto* row4 = new QWidget(gPlot);
+    auto* r4 = new QHBoxLayout(row4);
+    r4->addWidget(new QLabel("Decimate"));
+    r4->addWidget(sp_decim_);
+    r4->addWidget(new QLabel("taps"));
+    r4->addWidget(sp_decim_taps_);
+    pL->addWidget(row4);
+
     ctrlL->addWidget(gPlot);
 
     auto* gFilters = new QGroupBox("Filters", ctrlPanel);
@@ -289,6 +339,12 @@ void MainWindow::buildUi() {
     sp_q_->setDecimals(2);
     sp_q_->setValue(30.0);
 
+    // 1 = fundamental only; more adds 2*f0, 3*f0, ... (aliases included).
+    sp_notch_harm_ = new QSpinBox(gFilters);
+    sp_notch_harm_->setRange(1, 32);
+    sp_notch_harm_->setValue(1);
+    sp_notch_harm_->setToolTip("Harmonics of f0 to notch (mains hum)");
+
     auto* notchRow = new QWidget(gFilters);
     auto* notchL = new QHBoxLayout(notchRow);
     notchL->addWidget(cb_notch_);
@@ -298,10 +354,129 @@ void MainWindow::buildUi() {
     notchL->addWidget(sp_f0_);
     notchL->addWidget(new QLabel("Q"));
     notchL->addWidget(sp_q_);
+    notchL->addWidget(new QLabel("harm"));
+    notchL->addWidget(sp_notch_harm_);
     fL->addWidget(notchRow);
 
+    cb_resample_ = new QCheckBox("Resample to fs", gFilters);
+    cb_resample_->setChecked(false);
+    cb_resample_->setToolTip("Interpolate the frames onto a uniform fs grid from their timestamps\n"
+                             "before the filters; fs then no longer follows the rate estimate.");
+
+    cb_resample_method_ = new QComboBox(gFilters);
+    cb_resample_method_->addItem("Linear", (int)hub::ResampleMethod::Linear);
+    cb_resample_method_->addItem("Sinc", (int)hub::ResampleMethod::Sinc);
+    cb_resample_method_->setToolTip("Sinc: band-limited, needs steady timestamps, adds ~8 periods of latency");
+
+    auto* resampleRow = new QWidget(gFilters);
+    auto* resampleL = new QHBoxLayout(resampleRow);
+    resampleL->addWidget(cb_resample_);
+    resampleL->addWidget(cb_resample_method_);
+    resampleL->addStretch(1);
+    fL->addWidget(resampleRow);
+
+    // Explicit stage order; overrides the checkboxes above while not empty.
+    ed_chain_ = new QLineEdit(gFilters);
+    ed_chain_->setPlaceholderText("ma:5,ema:0.2,notch:60:30,bias");
+    static const QString kChainHelp = "Stages run left to right and may repeat (bias once).\n"
+                                      "ma:N  ema:A  notch:F0[:Q]  hum:F0[:HARMONICS[:Q]]  bias\n"
+                                      "lp:FC  hp:FC  bp:F1:F2, each [:ORDER[:RIPPLE_DB]]\n"
+                                      "(Butterworth, Chebyshev I with a ripple; uses fs)\n"
+                                      "fir:KERNEL_FILE  firlp:FC  firhp:FC  firbp:F1:F2, each [:TAPS]\n"
+                                      "median:W  hampel:W[:K]  (spike rejection, K sigma, default 3)\n"
+                                      "Empty: the checkboxes above, in their order.";
+    ed_chain_->setToolTip(kChainHelp);
+
+    auto* chainRow = new QWidget(gFilters);
+    auto* chainL = new QHBoxLayout(chainRow);
+    chainL->addWidget(new QLabel("Chain"));
+    chainL->addWidget(ed_chain_, 1);
+    lb_delay_ = new QLabel("Delay: 0", gFilters);
+    lb_delay_->setToolTip("Group delay of the MA, median and FIR stages plus FIR block latency;\n"
+                          "the plot and tracking are shifted back by it");
+    chainL->addWidget(lb_delay_);
+    fL->addWidget(chainRow);
+
     ctrlL->addWidget(gFilters);
 
+    auto* gSerial = new QGroupBox("Serial", ctrlPanel);
+    auto* sL = new QHBoxLayout(gSerial);
+
+    cb_baud_ = new QComboBox(gSerial);
+    cb_baud_->setEditable(true);
+    for (int b : {115200, 230400, 460800, 921600, 1000000, 2000000, 3000000, 4000000}) {
+        cb_baud_->addItem(QString::number(b));
+    }
+    cb_baud_->setValidator(new QIntValidator(1200, 4000000, cb_baud_));
+
+    sp_read_chunk_ = new QSpinBox(gSerial);
+    sp_read_chunk_->setRange(64, 262144);
+    sp_read_chunk_->setSingleStep(1024);
+    sp_read_chunk_->setValue(4096);
+
+    cb_low_latency_ = new QCheckBox("Low latency", gSerial);
+    cb_low_latency_->setChecked(true);
+
+    sL->addWidget(new QLabel("Baud"));
+    sL->addWidget(cb_baud_);
+    sL->addWidget(new QLabel("Read"));
+    sL->addWidget(sp_read_chunk_);
+    sL->addWidget(cb_low_latency_);
+    sL->addStretch(1);
+
+    ctrlL->addWidget(gSerial);
+
+    auto* gCols = new QGroupBox("Device columns", ctrlPanel);
+    auto* dcL = new QVBoxLayout(gCols);
+
+    auto makeColSpin = [gCols]() {
+        auto* sp = new QSpinBox(gCols);
+        sp->setRange(-1, 511);
+        sp->setSpecialValueText("none");
+        sp->setValue(-1);
+        return sp;
+    };
+    auto makeBitsSpin = [gCols]() {
+        auto* sp = new QSpinBox(gCols);
+        sp->setRange(0, 64);
+        sp->setSpecialValueText("no wrap");
+        sp->setValue(0);
+        return sp;
+    };
+
+    sp_seq_col_ = makeColSpin();
+    sp_seq_bits_ = makeBitsSpin();
+    sp_time_col_ = makeColSpin();
+    sp_time_bits_ = makeBitsSpin();
+
+    cb_time_unit_ = new QComboBox(gCols);
+    cb_time_unit_->addItem("ns", 1e-9);
+    cb_time_unit_->addItem("us", 1e-6);
+    cb_time_unit_->addItem("ms", 1e-3);
+    cb_time_unit_->addItem("s", 1.0);
+    cb_time_unit_->setCurrentIndex(1);
+
+    auto* seqRow = new QWidget(gCols);
+    auto* seqL = new QHBoxLayout(seqRow);
+    seqL->addWidget(new QLabel("Seq col"));
+    seqL->addWidget(sp_seq_col_);
+    seqL->addWidget(new QLabel("bits"));
+    seqL->addWidget(sp_seq_bits_);
+    seqL->addStretch(1);
+    dcL->addWidget(seqRow);
+
+    auto* timeRow = new QWidget(gCols);
+    auto* timeL = new QHBoxLayout(timeRow);
+    timeL->addWidget(new QLabel("Time col"));
+    timeL->addWidget(sp_time_col_);
+    timeL->addWidget(cb_time_unit_);
+    timeL->addWidget(new QLabel("bits"));
+    timeL->addWidget(sp_time_bits_);
+    timeL->addStretch(1);
+    dcL->addWidget(timeRow);
+
+    ctrlL->addWidget(gCols);
+
     cb_bias_apply_ = new QCheckBox("Apply stored bias", ctrlPanel);
     cb_bias_apply_->setChecked(false);
     sp_bias_frames_ = new QSpinBox(ctrlPanel);
@@ -340,11 +515,29 @@ void MainWindow::buildUi() {
     recL->addWidget(btn_browse_csv_);
     ctrlL->addWidget(recRow);
 
+    // Plays a recording (or raw capture) through the primary worker.
+    cb_replay_speed_ = new QComboBox(ctrlPanel);
+    cb_replay_speed_->addItem("1x", 1.0);
+    cb_replay_speed_->addItem("2x", 2.0);
+    cb_replay_speed_->addItem("10x", 10.0);
+    cb_replay_speed_->addItem("Max", 0.0);
+    btn_replay_ = new QPushButton("Replay...", ctrlPanel);
+    connect(btn_replay_, &QPushButton::clicked, this, &MainWindow::onReplay);
+
+    auto* replayRow = new QWidget(ctrlPanel);
+    auto* replayL = new QHBoxLayout(replayRow);
+    replayL->addWidget(new QLabel("Speed"));
+    replayL->addWidget(cb_replay_speed_);
+    replayL->addWidget(btn_replay_, 1);
+    ctrlL->addWidget(replayRow);
+
     ctrlL->addStretch(1);
 
     auto applyHook = [this]() { onAnyControlChanged(); };
 
     connect(sp_xwin_, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double) { clearPlotData(); });
+    connect(sp_decim_, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int) { applyDecimationNow(); });
+    connect(sp_decim_taps_, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int) { applyDecimationNow(); });
 
     connect(sp_ycenter_, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, applyHook);
     connect(sp_yabs_, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, applyHook);
@@ -358,11 +551,36 @@ void MainWindow::buildUi() {
 
     connect(cb_notch_, &QCheckBox::toggled, this, applyHook);
     connect(sp_fs_, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, applyHook);
+    connect(sp_fs_, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double) {
+        if (cb_resample_->isChecked()) applyResampleNow();
+    });
+    connect(cb_resample_, &QCheckBox::toggled, this, [this](bool) { applyResampleNow(); });
+    connect(cb_resample_method_, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+            [this](int) { applyResampleNow(); });
     connect(sp_f0_, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, applyHook);
     connect(sp_q_,  QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, applyHook);
+    connect(sp_notch_harm_, QOverload<int>::of(&QSpinBox::valueChanged), this, applyHook);
 
     connect(cb_bias_apply_, &QCheckBox::toggled, this, applyHook);
 
+    connect(ed_chain_, &QLineEdit::textChanged, this, [this, applyHook](const QString& text) {
+        std::vector<hub::StageSpec> stages;
+        std::string err;
+        const bool ok = hub::parse_stage_chain(text.toStdString(), stages, err);
+        ed_chain_->setStyleSheet(ok ? QString() : QString("QLineEdit { color: #d04040; }"));
+        ed_chain_->setToolTip(ok ? kChainHelp : QString::fromStdString(err) + "\n\n" + kChainHelp);
+        if (ok) applyHook();
+    });
+
+    connect(cb_baud_, &QComboBox::currentTextChanged, this, [this](const QString&) { applySerialNow(); });
+    connect(sp_read_chunk_, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int) { applySerialNow(); });
+    connect(cb_low_latency_, &QCheckBox::toggled, this, [this](bool) { applySerialNow(); });
+
+    for (auto* sp : {sp_seq_col_, sp_seq_bits_, sp_time_col_, sp_time_bits_}) {
+        connect(sp, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int) { applyCsvLayoutNow(); });
+    }
+    connect(cb_time_unit_, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int) { applyCsvLayoutNow(); });
+
     split->addWidget(ctrlPanel);
     split->setStretchFactor(0, 2);
     split->setStretchFactor(1, 16);
@@ -387,11 +605,42 @@ hub::PipelineConfig MainWindow::readCfgFromUi() const {
     cfg.fs_hz = sp_fs_->value();
     cfg.notch_f0 = sp_f0_->value();
     cfg.notch_q  = sp_q_->value();
+    cfg.notch_harmonics = sp_notch_harm_->value();
 
     cfg.enable_bias = cb_bias_apply_->isChecked();
+
+    std::string err;
+    if (!hub::parse_stage_chain(ed_chain_->text().toStdString(), cfg.stages, err)) cfg.stages.clear();
+    return cfg;
+}
+
+hub::SerialConfig MainWindow::readSerialCfgFromUi() const {
+    hub::SerialConfig cfg;
+    bool ok = false;
+    uint32_t baud = cb_baud_->currentText().toUInt(&ok);
+    if (ok && baud > 0) cfg.baud = baud;
+    cfg.read_chunk = (size_t)sp_read_chunk_->value();
+    cfg.low_latency = cb_low_latency_->isChecked();
+    return cfg;
+}
+
+hub::ResamplerConfig MainWindow::readResampleCfgFromUi() const {
+    hub::ResamplerConfig cfg;
+    cfg.fs_hz = sp_fs_->value();
+    cfg.method = (hub::ResampleMethod)cb_resample_method_->currentData().toInt();
     return cfg;
 }
 
+hub::CsvLayout MainWindow::readCsvLayoutFromUi() const {
+    hub::CsvLayout layout;
+    layout.seq_col = sp_seq_col_->value();
+    layout.seq_bits = (unsigned)sp_seq_bits_->value();
+    layout.time_col = sp_time_col_->value();
+    layout.time_bits = (unsigned)sp_time_bits_->value();
+    layout.time_unit_s = cb_time_unit_->currentData().toDouble();
+    return layout;
+}
+
 void MainWindow::rescalePlotTime(double ratio) {
     for (auto& buf : buffers_) {
         for (auto& pt : buf) {
@@ -444,7 +693,31 @@ void MainWindow::onAnyControlChanged() {
 
 void MainWindow::applyPipelineNow() {
     auto cfg = readCfgFromUi();
-    QMetaObject::invokeMethod(worker_, [w = worker_, cfg]() { w->setPipelineConfig(cfg); }, Qt::QueuedConnection);
+    hub_->forEachWorker([cfg](BleWorker* w) { w->setPipelineConfig(cfg); });
+}
+
+void MainWindow::applyDecimationNow() {
+    const int factor = sp_decim_->value();
+    const int taps = sp_decim_taps_->value();
+    hub_->forEachWorker([factor, taps](BleWorker* w) { w->setDisplayDecimation(factor, taps); });
+    clearPlotData();
+}
+
+void MainWindow::applyResampleNow() {
+    const bool on = cb_resample_->isChecked();
+    const auto rcfg = readResampleCfgFromUi();
+    hub_->forEachWorker([on, rcfg](BleWorker* w) { w->setResampling(on, rcfg); });
+    clearPlotData();
+}
+
+void MainWindow::applySerialNow() {
+    auto cfg = readSerialCfgFromUi();
+    hub_->forEachWorker([cfg](BleWorker* w) { w->setSerialConfig(cfg); });
+}
+
+void MainWindow::applyCsvLayoutNow() {
+    auto layout = readCsvLayoutFromUi();
+    hub_->forEachWorker([layout](BleWorker* w) { w->setCsvLayout(layout); });
 }
 
 void MainWindow::onBiasCapture() {
@@ -464,6 +737,16 @@ void MainWindow::onBrowseCsv() {
     ed_csv_path_->setText(path);
 }
 
+void MainWindow::onReplay() {
+    QString path = QFileDialog::getOpenFileName(this, "Replay", "", "Recordings (*.csv);;All files (*)");
+    if (path.isEmpty()) return;
+
+    hub::ReplayConfig cfg;
+    cfg.speed = cb_replay_speed_->currentData().toDouble();
+
+    QMetaObject::invokeMethod(worker_, [w = worker_, path, cfg]() { w->startReplay(path, cfg); }, Qt::QueuedConnection);
+}
+
 void MainWindow::onToggleRecord(bool on) {
     if (on) {
         if (ed_csv_path_->text().isEmpty()) {
@@ -481,12 +764,19 @@ void MainWindow::onToggleRecord(bool on) {
 }
 
 void MainWindow::onOpenPositionTracking() {
-    if (!ptWin_) ptWin_ = new PositionTrackingWindow(worker_, this);
+    if (!ptWin_) ptWin_ = new PositionTrackingWindow(hub_, this);
     ptWin_->show();
     ptWin_->raise();
     ptWin_->activateWindow();
 }
 
+void MainWindow::onOpenSpectrum() {
+    if (!specWin_) specWin_ = new SpectrumWindow(worker_, this);
+    specWin_->show();
+    specWin_->raise();
+    specWin_->activateWindow();
+}
+
 void MainWindow::onScanUpdated(QVector<DeviceInfo> devices) {
     devices_ = devices;
 
@@ -505,6 +795,8 @@ void MainWindow::onScanUpdated(QVector<DeviceInfo> devices) {
         QString text;
         if (d.kind == DeviceKind::Ble) {
             text = QString("%1  (%2)  rssi=%3").arg(d.name).arg(d.address).arg(d.rssi);
+        } else if (d.kind == DeviceKind::Simulator) {
+            text = QString("[SIM] %1").arg(d.name);
         } else {
             text = QString("[COM] %1").arg(d.name);
         }
@@ -552,6 +844,7 @@ void MainWindow::updateDeviceListDecor() {
 
         int st = 0;
         if (!connectedAddr_.isEmpty() && addr == connectedAddr_) st = 1;
+        if (hub_ && hub_->hasDevice(addr)) st = 1;
         if (connecting_ && addr == connectingAddr_) st = 2;
 
         it->setData(ROLE_STATE, st);
@@ -576,12 +869,48 @@ void MainWindow::onDeviceClicked(QListWidgetItem* item) {
     int scanIndex = item->data(ROLE_SCAN_INDEX).toInt();
 
     if (!connectedAddr_.isEmpty() && addr == connectedAddr_) return;
+    if (hub_->hasDevice(addr)) return;
     if (scanIndex < 0) return;
 
     beginConnecting(addr, name);
     QMetaObject::invokeMethod(worker_, [w = worker_, scanIndex]() { w->connectToIndex(scanIndex); }, Qt::QueuedConnection);
 }
 
+void MainWindow::onDeviceContextMenu(const QPoint& pos) {
+    auto* item = list_->itemAt(pos);
+    if (!item) return;
+
+    QString addr = item->data(ROLE_ADDR).toString();
+    int scanIndex = item->data(ROLE_SCAN_INDEX).toInt();
+
+    QMenu menu(this);
+    if (hub_->hasDevice(addr)) {
+        menu.addAction("Disconnect additional device", this, [this, addr]() { hub_->removeDevice(addr); });
+    } else if (scanIndex >= 0 && addr != connectedAddr_ && !connectedAddr_.isEmpty()) {
+        // Each session gets the current UI settings before it connects.
+        auto cfg = readCfgFromUi();
+        auto serialCfg = readSerialCfgFromUi();
+        auto layout = readCsvLayoutFromUi();
+        const int decim = sp_decim_->value();
+        const int decimTaps = sp_decim_taps_->value();
+        const bool resample = cb_resample_->isChecked();
+        const auto rcfg = readResampleCfgFromUi();
+        menu.addAction("Connect as additional device", this,
+                       [this, scanIndex, cfg, serialCfg, layout, decim, decimTaps, resample, rcfg]() {
+            hub_->addDevice(scanIndex, [cfg, serialCfg, layout, decim, decimTaps, resample, rcfg](BleWorker* w) {
+                w->setPipelineConfig(cfg);
+                w->setSerialConfig(serialCfg);
+                w->setCsvLayout(layout);
+                w->setDisplayDecimation(decim, decimTaps);
+                w->setResampling(resample, rcfg);
+            });
+        });
+    } else {
+        return;
+    }
+    menu.exec(list_->viewport()->mapToGlobal(pos));
+}
+
 void MainWindow::onStatus(QString text) {
     status_->setText(text);
 
@@ -601,7 +930,6 @@ void MainWindow::onConnected(QString name, QString addr) {
     endConnecting();
     updateDeviceListDecor();
 
-    fsAutoSetDone_ = false;
     clearPlotData();
 }
 
@@ -616,8 +944,10 @@ void MainWindow::onDisconnected() {
     updateDeviceListDecor();
 }
 
-void MainWindow::onStats(qulonglong ok, qulonglong bad) {
-    stats_->setText(QString("ok=%1 bad=%2").arg(ok).arg(bad));
+void MainWindow::onStats(qulonglong ok, qulonglong bad, qulonglong overflowBytes, qulonglong ringHighWater,
+                         qulonglong lost) {
+    stats_->setText(QString("ok=%1 bad=%2 lost=%3 | ring peak=%4 KiB overflow=%5 B")
+        .arg(ok).arg(bad).arg(lost).arg(ringHighWater / 1024).arg(overflowBytes));
 }
 
 void MainWindow::onBiasState(bool hasBias, bool capturing) {
@@ -633,31 +963,42 @@ void MainWindow::onStreamStats(qulonglong totalSamples, double totalTimeSec, qul
         .arg(totalTimeSec, 0, 'f', 3)
         .arg(last1sSamples)
         .arg(dt_ms, 0, 'f', 3));
+}
+
+void MainWindow::onRateEstimated(double fsHz) {
+    if (fsHz < 1.0) return;
+
+    // Resampled streams run at fs whatever the device does.
+    if (cb_resample_->isChecked()) {
+        status_->setText(QString("Device rate: %1 Hz (resampled to %2 Hz)")
+                             .arg(fsHz, 0, 'f', 2).arg(sp_fs_->value(), 0, 'f', 2));
+        return;
+    }
 
-    // ✅ plot x간격은 uniform이지만, fs를 더 정확히 만들고 싶으면 "한 번만" rescale
-    if (!fsAutoSetDone_ && totalTimeSec >= 1.0 && last1sSamples > 0) {
-        fsAutoSetDone_ = true;
+    // Hysteresis: follow the estimate only when it moved by more than 1%, so the
+    // plot and the notch coefficients are not rewritten on every stats tick.
+    if (std::fabs(fsHz - plotFs_) <= 0.01 * plotFs_) return;
 
-        double newFs = (double)last1sSamples;
-        if (newFs < 1.0) newFs = 1.0;
+    double oldFs = plotFs_;
+    plotFs_ = fsHz;
+    dtPlot_ = 1.0 / plotFs_;
 
-        double oldFs = plotFs_;
-        plotFs_ = newFs;
-        dtPlot_ = 1.0 / plotFs_;
+    // x축 전체를 리셋하지 않고, 기존 점들 x만 스케일 보정
+    // x = k*(1/oldFs) -> k*(1/newFs) => x *= oldFs/newFs
+    rescalePlotTime(oldFs / fsHz);
 
-        // x축 전체를 리셋하지 않고, 기존 점들 x만 스케일 보정
-        // x = k*(1/oldFs) -> k*(1/newFs) => x *= oldFs/newFs
-        double ratio = oldFs / newFs;
-        rescalePlotTime(ratio);
+    sp_fs_->setValue(fsHz);
+    status_->setText(QString("Sampling rate: %1 Hz (estimated)").arg(fsHz, 0, 'f', 2));
+}
 
-        sp_fs_->setValue(newFs);
-        status_->setText(QString("Sampling rate auto-set: %1 Hz").arg((int)newFs));
-    }
+void MainWindow::onPipelineDelay(double frames) {
+    delayFrames_ = frames;
+    lb_delay_->setText(QString("Delay: %1 ms").arg(frames * dtPlot_ * 1e3, 0, 'f', 1));
 }
 
 void MainWindow::onFrame(qulonglong, QVector<float> x, bool, float) {
-    double t = (double)sampleIndex_ * dtPlot_;
-    sampleIndex_++;
+    double t = ((double)sampleIndex_ - delayFrames_) * dtPlot_;
+    sampleIndex_ += (uint64_t)sp_decim_->value();
     pending_.push_back(PendingFrame{t, std::move(x)});
 }
 
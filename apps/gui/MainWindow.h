@@ -15,6 +15,7 @@
 #include <QDoubleSpinBox>
 #include <QPushButton>
 #include <QLineEdit>
+#include <QComboBox>
 
 #include <QtCharts/QChartView>
 #include <QtCharts/QLineSeries>
@@ -25,9 +26,11 @@
 #include <cstdint>
 
 #include "BleWorker.h"
+#include "DeviceHub.h"
 #include "hub/Pipeline.h"
 
 class PositionTrackingWindow;
+class SpectrumWindow;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -42,22 +45,32 @@ private slots:
     void onDisconnected();
 
     void onFrame(qulonglong t_ns, QVector<float> x, bool modelValid, float modelOut);
-    void onStats(qulonglong ok, qulonglong bad);
+    void onStats(qulonglong ok, qulonglong bad, qulonglong overflowBytes, qulonglong ringHighWater,
+                 qulonglong lost);
     void onBiasState(bool hasBias, bool capturing);
     void onStreamStats(qulonglong totalSamples, double totalTimeSec, qulonglong last1sSamples, double lastDtSec);
+    void onRateEstimated(double fsHz);
+    void onPipelineDelay(double frames);
 
     void onDeviceClicked(QListWidgetItem* item);
+    void onDeviceContextMenu(const QPoint& pos);
 
     void onAnyControlChanged();
     void applyPipelineNow();
+    void applySerialNow();
+    void applyCsvLayoutNow();
+    void applyDecimationNow();
+    void applyResampleNow();
 
     void onBiasCapture();
     void onBiasSave();
 
     void onBrowseCsv();
     void onToggleRecord(bool on);
+    void onReplay();
 
     void onOpenPositionTracking();
+    void onOpenSpectrum();
     void onPlotTick();
 
 private:
@@ -71,6 +84,9 @@ private:
     void clearPlotData();
     void updateDeviceListDecor();
     hub::PipelineConfig readCfgFromUi() const;
+    hub::SerialConfig readSerialCfgFromUi() const;
+    hub::CsvLayout readCsvLayoutFromUi() const;
+    hub::ResamplerConfig readResampleCfgFromUi() const;
 
     void beginConnecting(const QString& addr, const QString& name);
     void endConnecting();
@@ -79,9 +95,11 @@ private:
 
 private:
     QThread workerThread_;
-    BleWorker* worker_ = nullptr;
+    BleWorker* worker_ = nullptr;   // primary device + scanner
+    DeviceHub* hub_ = nullptr;      // additional devices, merged frame stream
 
     PositionTrackingWindow* ptWin_ = nullptr;
+    SpectrumWindow* specWin_ = nullptr;
 
     QVector<DeviceInfo> devices_;
 
@@ -100,6 +118,8 @@ private:
     QDoubleSpinBox* sp_ycenter_ = nullptr;
     QDoubleSpinBox* sp_yabs_ = nullptr;
     QCheckBox* cb_yauto_ = nullptr;
+    QSpinBox* sp_decim_ = nullptr;          // plot/tracking decimation factor
+    QSpinBox* sp_decim_taps_ = nullptr;     // its anti-alias filter length, 0 = auto
 
     // Filters
     QCheckBox* cb_ma_ = nullptr;
@@ -112,6 +132,25 @@ private:
     QDoubleSpinBox* sp_fs_ = nullptr;
     QDoubleSpinBox* sp_f0_ = nullptr;
     QDoubleSpinBox* sp_q_  = nullptr;
+    QSpinBox* sp_notch_harm_ = nullptr;
+
+    QCheckBox* cb_resample_ = nullptr;        // resample to fs before the filters
+    QComboBox* cb_resample_method_ = nullptr;
+
+    QLineEdit* ed_chain_ = nullptr;
+    QLabel* lb_delay_ = nullptr;
+
+    // Serial (applied on next connect)
+    QComboBox* cb_baud_ = nullptr;
+    QSpinBox* sp_read_chunk_ = nullptr;
+    QCheckBox* cb_low_latency_ = nullptr;
+
+    // Device columns in CSV lines (applied on next connect)
+    QSpinBox* sp_seq_col_ = nullptr;
+    QSpinBox* sp_seq_bits_ = nullptr;
+    QSpinBox* sp_time_col_ = nullptr;
+    QComboBox* cb_time_unit_ = nullptr;
+    QSpinBox* sp_time_bits_ = nullptr;
 
     // Bias
     QCheckBox* cb_bias_apply_ = nullptr;
@@ -122,12 +161,17 @@ private:
 
     // PositionTracking
     QPushButton* btn_pt_ = nullptr;
+    QPushButton* btn_spec_ = nullptr;
 
     // CSV record
     QCheckBox* cb_record_ = nullptr;
     QLineEdit* ed_csv_path_ = nullptr;
     QPushButton* btn_browse_csv_ = nullptr;
 
+    // Replay (primary worker)
+    QComboBox* cb_replay_speed_ = nullptr;
+    QPushButton* btn_replay_ = nullptr;
+
     // Chart
     QChartView* chartView_ = nullptr;
     QChart* chart_ = nullptr;
@@ -140,15 +184,14 @@ private:
     std::vector<PendingFrame> pending_;
 
     // ---- uniform-x plot clock ----
-    uint64_t sampleIndex_ = 0;      // increments by 1 per sample(line)
-    double plotFs_ = 200.0;         // fixed (can be updated once by auto-measure with rescale)
+    uint64_t sampleIndex_ = 0;      // device frames so far: decimation factor per plotted frame
+    double plotFs_ = 200.0;         // follows the worker's rate estimate (with rescale)
     double dtPlot_ = 1.0 / 200.0;   // 1/plotFs_
+    double delayFrames_ = 0.0;      // pipeline delay; samples are plotted that much earlier
 
     QTimer* plotTimer_ = nullptr;
     QTimer* applyTimer_ = nullptr;
 
-    bool fsAutoSetDone_ = false;
-
     // Connecting UI
     bool connecting_ = false;
     QString connectingAddr_;
@@ -1,5 +1,5 @@
 #include "PositionTrackingWindow.h"
-#include "BleWorker.h"
+#include "DeviceHub.h"
 #include "PositionTrackingEngine.h"
 #include "hub/model/BruteForce_16x2.h"
 #include "FormatDoubleSpinBox.h"
@@ -15,8 +15,8 @@
 #include <algorithm>
 #include <cmath>
 
-PositionTrackingWindow::PositionTrackingWindow(BleWorker* worker, QWidget* parent)
-    : QMainWindow(parent), worker_(worker) {
+PositionTrackingWindow::PositionTrackingWindow(DeviceHub* hub, QWidget* parent)
+    : QMainWindow(parent), hub_(hub) {
 
     engine_ = new PositionTrackingEngine();
     engine_->moveToThread(&engineThread_);
@@ -48,7 +48,7 @@ PositionTrackingWindow::PositionTrackingWindow(BleWorker* worker, QWidget* paren
 
 PositionTrackingWindow::~PositionTrackingWindow() {
     if (connected_) {
-        QObject::disconnect(worker_, &BleWorker::frameReady, engine_, &PositionTrackingEngine::onSample);
+        QObject::disconnect(hub_, &DeviceHub::frameReady, engine_, &PositionTrackingEngine::onSample);
         connected_ = false;
     }
     engineThread_.quit();
@@ -60,7 +60,7 @@ PositionTrackingWindow::~PositionTrackingWindow() {
 void PositionTrackingWindow::showEvent(QShowEvent* e) {
     QMainWindow::showEvent(e);
     if (!connected_) {
-        QObject::connect(worker_, &BleWorker::frameReady, engine_, &PositionTrackingEngine::onSample, Qt::QueuedConnection);
+        QObject::connect(hub_, &DeviceHub::frameReady, engine_, &PositionTrackingEngine::onSample, Qt::QueuedConnection);
         connected_ = true;
     }
     if (timer_ && !timer_->isActive()) timer_->start();
@@ -69,7 +69,7 @@ void PositionTrackingWindow::showEvent(QShowEvent* e) {
 void PositionTrackingWindow::hideEvent(QHideEvent* e) {
     QMainWindow::hideEvent(e);
     if (connected_) {
-        QObject::disconnect(worker_, &BleWorker::frameReady, engine_, &PositionTrackingEngine::onSample);
+        QObject::disconnect(hub_, &DeviceHub::frameReady, engine_, &PositionTrackingEngine::onSample);
         connected_ = false;
     }
     if (timer_ && timer_->isActive()) timer_->stop();
@@ -26,13 +26,13 @@
 
 class FormatDoubleSpinBox;
 
-class BleWorker;
+class DeviceHub;
 class PositionTrackingEngine;
 
 class PositionTrackingWindow : public QMainWindow {
     Q_OBJECT
 public:
-    explicit PositionTrackingWindow(BleWorker* worker, QWidget* parent = nullptr);
+    explicit PositionTrackingWindow(DeviceHub* hub, QWidget* parent = nullptr);
     ~PositionTrackingWindow();
 
 protected:
@@ -64,7 +64,7 @@ private:
         double x, y, z, confidence, q1, q2, err;
     };
 
-    BleWorker* worker_ = nullptr;
+    DeviceHub* hub_ = nullptr;
 
     QThread engineThread_;
     PositionTrackingEngine* engine_ = nullptr;
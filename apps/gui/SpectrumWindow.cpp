@@ -0,0 +1,262 @@
+#include "SpectrumWindow.h"
+#include "BleWorker.h"
+
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QFormLayout>
+#include <QSplitter>
+#include <QGroupBox>
+#include <QPainter>
+#include <QPixmap>
+#include <QColor>
+#include <QMetaObject>
+#include <QtCore/QOverload>
+#include <algorithm>
+#include <cmath>
+
+// Spectrogram history, in snapshots (100 ms each at full rate).
+static constexpr int kHistory = 600;
+
+static QRgb heat(double v) {
+    // Dark blue (floor) -> red -> yellow (peak).
+    v = std::min(std::max(v, 0.0), 1.0);
+    const double r = std::min(1.0, 2.0 * v);
+    const double g = std::max(0.0, 2.0 * v - 1.0);
+    const double b = v < 0.5 ? 0.5 - v : 0.0;
+    return qRgb((int)(255 * r), (int)(255 * g), (int)(255 * (0.2 + b)));
+}
+
+SpectrumWindow::SpectrumWindow(BleWorker* worker, QWidget* parent)
+    : QMainWindow(parent), worker_(worker) {
+    buildUi();
+}
+
+SpectrumWindow::~SpectrumWindow() {
+    if (connected_) setEnabledOnWorker(false);
+}
+
+void SpectrumWindow::showEvent(QShowEvent* e) {
+    QMainWindow::showEvent(e);
+    if (!connected_) setEnabledOnWorker(true);
+}
+
+void SpectrumWindow::hideEvent(QHideEvent* e) {
+    QMainWindow::hideEvent(e);
+    if (connected_) setEnabledOnWorker(false);
+}
+
+void SpectrumWindow::closeEvent(QCloseEvent* e) {
+    this->hide();
+    e->ignore();
+}
+
+void SpectrumWindow::setEnabledOnWorker(bool on) {
+    if (on) {
+        connect(worker_, &BleWorker::spectrumReady, this, &SpectrumWindow::onSpectrum, Qt::QueuedConnection);
+    } else {
+        QObject::disconnect(worker_, &BleWorker::spectrumReady, this, &SpectrumWindow::onSpectrum);
+    }
+    connected_ = on;
+
+    const auto cfg = readCfgFromUi();
+    QMetaObject::invokeMethod(worker_, [w = worker_, on, cfg]() { w->setSpectrum(on, cfg); }, Qt::QueuedConnection);
+}
+
+void SpectrumWindow::buildUi() {
+    setWindowTitle("Spectrum");
+    resize(1100, 800);
+
+    auto* central = new QWidget(this);
+    auto* root = new QHBoxLayout(central);
+
+    auto* split = new QSplitter(Qt::Horizontal, central);
+    split->setChildrenCollapsible(false);
+
+    auto* plotW = new QWidget(split);
+    auto* plotL = new QVBoxLayout(plotW);
+
+    chart_ = new QChart();
+    chart_->legend()->hide();
+
+    axX_ = new QValueAxis();
+    axY_ = new QValueAxis();
+    axX_->setTitleText("Hz");
+    axY_->setTitleText("dB (units^2/Hz)");
+    axX_->setLabelFormat("%.1f");
+    axY_->setLabelFormat("%.0f");
+    chart_->addAxis(axX_, Qt::AlignBottom);
+    chart_->addAxis(axY_, Qt::AlignLeft);
+
+    psdSeries_ = new QLineSeries(chart_);
+    chart_->addSeries(psdSeries_);
+    psdSeries_->attachAxis(axX_);
+    psdSeries_->attachAxis(axY_);
+
+    view_ = new QChartView(chart_, plotW);
+    view_->setRenderHint(QPainter::Antialiasing, true);
+    plotL->addWidget(view_, 1);
+
+    specgram_ = new QLabel(plotW);
+    specgram_->setMinimumHeight(260);
+    specgram_->setScaledContents(true);
+    specgram_->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
+    plotL->addWidget(specgram_, 1);
+
+    lbStats_ = new QLabel("waiting...", plotW);
+    lbStats_->setObjectName("StatusLabel");
+    plotL->addWidget(lbStats_);
+
+    split->addWidget(plotW);
+
+    auto* ctrlW = new QWidget(split);
+    ctrlW->setMinimumWidth(260);
+    auto* ctrlL = new QVBoxLayout(ctrlW);
+
+    auto* gCfg = new QGroupBox("Analysis", ctrlW);
+    auto* form = new QFormLayout(gCfg);
+
+    spChannel_ = new QSpinBox(gCfg);
+    spChannel_->setRange(0, 0);
+
+    cbFft_ = new QComboBox(gCfg);
+    for (int n : {128, 256, 512, 1024, 2048, 4096}) cbFft_->addItem(QString::number(n), n);
+    cbFft_->setCurrentIndex(1);
+
+    cbOverlap_ = new QComboBox(gCfg);
+    cbOverlap_->addItem("0%", 1);
+    cbOverlap_->addItem("50%", 2);
+    cbOverlap_->addItem("75%", 4);
+    cbOverlap_->setCurrentIndex(1);
+
+    spAverage_ = new QSpinBox(gCfg);
+    spAverage_->setRange(1, 64);
+    spAverage_->setValue(8);
+    spAverage_->setToolTip("Welch: periodograms averaged");
+
+    cbWindow_ = new QComboBox(gCfg);
+    cbWindow_->addItem("Hann", (int)hub::SpectrumWindow::Hann);
+    cbWindow_->addItem("Hamming", (int)hub::SpectrumWindow::Hamming);
+    cbWindow_->addItem("Blackman", (int)hub::SpectrumWindow::Blackman);
+    cbWindow_->addItem("Rect", (int)hub::SpectrumWindow::Rect);
+
+    spRange_ = new QDoubleSpinBox(gCfg);
+    spRange_->setRange(10.0, 200.0);
+    spRange_->setValue(80.0);
+    spRange_->setSuffix(" dB");
+    spRange_->setToolTip("Range below the peak shown in the plot and the spectrogram");
+
+    form->addRow("Channel", spChannel_);
+    form->addRow("FFT size", cbFft_);
+    form->addRow("Overlap", cbOverlap_);
+    form->addRow("Average", spAverage_);
+    form->addRow("Window", cbWindow_);
+    form->addRow("Range", spRange_);
+    ctrlL->addWidget(gCfg);
+    ctrlL->addStretch(1);
+
+    split->addWidget(ctrlW);
+    split->setStretchFactor(0, 1);
+    root->addWidget(split);
+    setCentralWidget(central);
+
+    connect(cbFft_, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int) { applyConfig(); });
+    connect(cbOverlap_, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int) { applyConfig(); });
+    connect(spAverage_, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int) { applyConfig(); });
+    connect(cbWindow_, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int) { applyConfig(); });
+    connect(spChannel_, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int) {
+        image_ = QImage();
+        redraw();
+    });
+    connect(spRange_, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double) { redraw(); });
+}
+
+hub::SpectrumConfig SpectrumWindow::readCfgFromUi() const {
+    hub::SpectrumConfig cfg;
+    cfg.fft_size = (size_t)cbFft_->currentData().toInt();
+    cfg.hop = cfg.fft_size / (size_t)cbOverlap_->currentData().toInt();
+    cfg.average = (size_t)spAverage_->value();
+    cfg.window = (hub::SpectrumWindow)cbWindow_->currentData().toInt();
+    return cfg;
+}
+
+void SpectrumWindow::applyConfig() {
+    image_ = QImage();
+    psd_.clear();
+    if (connected_) {
+        const auto cfg = readCfgFromUi();
+        QMetaObject::invokeMethod(worker_, [w = worker_, cfg]() { w->setSpectrum(true, cfg); }, Qt::QueuedConnection);
+    }
+    redraw();
+}
+
+void SpectrumWindow::onSpectrum(QVector<float> psd, int nCh, double binHz, int averaged) {
+    if (nCh <= 0 || psd.size() % nCh != 0) return;
+
+    const int bins = psd.size() / nCh;
+    if (nCh != nCh_ || bins != bins_ || binHz != binHz_) image_ = QImage();
+    if (nCh != nCh_) spChannel_->setRange(0, nCh - 1);
+
+    psd_ = std::move(psd);
+    nCh_ = nCh;
+    bins_ = bins;
+    binHz_ = binHz;
+    averaged_ = averaged;
+
+    const int ch = std::min(spChannel_->value(), nCh_ - 1);
+    const float* p = psd_.constData() + (size_t)ch * bins_;
+    const double peak = 10.0 * std::log10((double)*std::max_element(p, p + bins_) + 1e-30);
+    const double range = spRange_->value();
+
+    // Scroll left by one column and add the newest at the right.
+    if (image_.isNull()) {
+        image_ = QImage(kHistory, bins_, QImage::Format_RGB32);
+        image_.fill(heat(0.0));
+    }
+    for (int y = 0; y < bins_; ++y) {
+        QRgb* line = reinterpret_cast<QRgb*>(image_.scanLine(bins_ - 1 - y));
+        std::move(line + 1, line + kHistory, line);
+        const double db = 10.0 * std::log10((double)p[y] + 1e-30);
+        line[kHistory - 1] = heat((db - (peak - range)) / range);
+    }
+
+    redraw();
+}
+
+void SpectrumWindow::redraw() {
+    if (nCh_ <= 0 || psd_.size() != nCh_ * bins_) {
+        psdSeries_->clear();
+        specgram_->clear();
+        lbStats_->setText("waiting...");
+        return;
+    }
+
+    const int ch = std::min(spChannel_->value(), nCh_ - 1);
+    const float* p = psd_.constData() + (size_t)ch * bins_;
+
+    QVector<QPointF> pts(bins_);
+    double peakDb = -1e300;
+    int peakBin = 0;
+    for (int k = 0; k < bins_; ++k) {
+        const double db = 10.0 * std::log10((double)p[k] + 1e-30);
+        pts[k] = QPointF(k * binHz_, db);
+        // DC aside, for the readout.
+        if (k > 0 && db > peakDb) {
+            peakDb = db;
+            peakBin = k;
+        }
+    }
+    psdSeries_->replace(pts);
+
+    const double top = std::ceil(std::max(peakDb, 10.0 * std::log10((double)p[0] + 1e-30)) / 10.0) * 10.0;
+    axX_->setRange(0.0, (bins_ - 1) * binHz_);
+    axY_->setRange(top - spRange_->value(), top);
+
+    if (!image_.isNull()) specgram_->setPixmap(QPixmap::fromImage(image_));
+
+    lbStats_->setText(QString("ch%1 | bin %2 Hz | %3 averaged | peak %4 Hz at %5 dB")
+        .arg(ch)
+        .arg(binHz_, 0, 'f', 3)
+        .arg(averaged_)
+        .arg(peakBin * binHz_, 0, 'f', 2)
+        .arg(peakDb, 0, 'f', 1));
+}
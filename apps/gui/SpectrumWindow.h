@@ -0,0 +1,76 @@
+#ifndef SOFTIONICS_GUI_SPECTRUMWINDOW_H
+#define SOFTIONICS_GUI_SPECTRUMWINDOW_H
+
+#include <QMainWindow>
+#include <QVector>
+#include <QImage>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include <QShowEvent>
+#include <QHideEvent>
+#include <QCloseEvent>
+
+#include <QtCharts/QChartView>
+#include <QtCharts/QChart>
+#include <QtCharts/QValueAxis>
+#include <QtCharts/QLineSeries>
+
+#include "hub/Spectrum.h"
+
+class BleWorker;
+
+// Welch PSD and spectrogram of one channel of the primary device. The worker
+// computes the spectra on its ingest thread while this window is shown and
+// sends a snapshot at most every 100 ms; each snapshot redraws the PSD and
+// adds one spectrogram column.
+class SpectrumWindow : public QMainWindow {
+    Q_OBJECT
+public:
+    explicit SpectrumWindow(BleWorker* worker, QWidget* parent = nullptr);
+    ~SpectrumWindow();
+
+protected:
+    void showEvent(QShowEvent* e) override;
+    void hideEvent(QHideEvent* e) override;
+    void closeEvent(QCloseEvent* e) override;
+
+private slots:
+    void onSpectrum(QVector<float> psd, int nCh, double binHz, int averaged);
+    void applyConfig();
+
+private:
+    void buildUi();
+    hub::SpectrumConfig readCfgFromUi() const;
+    void setEnabledOnWorker(bool on);
+    void redraw();
+
+    BleWorker* worker_ = nullptr;
+    bool connected_ = false;
+
+    QSpinBox* spChannel_ = nullptr;
+    QComboBox* cbFft_ = nullptr;
+    QComboBox* cbOverlap_ = nullptr;
+    QSpinBox* spAverage_ = nullptr;
+    QComboBox* cbWindow_ = nullptr;
+    QDoubleSpinBox* spRange_ = nullptr;     // dB below the peak shown
+
+    QChartView* view_ = nullptr;
+    QChart* chart_ = nullptr;
+    QValueAxis* axX_ = nullptr;
+    QValueAxis* axY_ = nullptr;
+    QLineSeries* psdSeries_ = nullptr;
+
+    QLabel* specgram_ = nullptr;
+    QImage image_;              // time left to right, frequency bottom to top
+    QLabel* lbStats_ = nullptr;
+
+    QVector<float> psd_;
+    int nCh_ = 0;
+    int bins_ = 0;
+    double binHz_ = 0.0;
+    int averaged_ = 0;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "hub/Frame.h"
+
+namespace hub {
+
+enum class WireFormat : int {
+    Unknown = 0,
+    Csv = 1,
+    Binary = 2,
+};
+
+// Binary wire protocol
+//
+// The byte stream is a sequence of COBS-encoded packets, each terminated by 0x00.
+// A decoded packet is (little-endian):
+//
+//   [0]      magic 0xB5
+//   [1]      sample encoding (BinaryEncoding)
+//   [2]      channel count n (1..255)
+//   [3..4]   sequence counter, +1 per frame, wraps at 65536
+//   [5..]    n samples
+//   [-2..-1] CRC-16/CCITT-FALSE over every preceding byte
+//
+// Integer encodings are delivered as raw counts (no scaling).
+enum class BinaryEncoding : uint8_t {
+    Int16 = 1,
+    Int24 = 2,
+    Float32 = 3,
+};
+
+class BinaryFrameDecoder {
+public:
+    static constexpr uint8_t kMagic = 0xB5;
+    static constexpr size_t kHeaderBytes = 5;
+    static constexpr size_t kMaxPacketBytes = kHeaderBytes + 255 * 4 + 2;
+
+    // Decodes every complete packet in `chunk` into `blk` (one row per packet,
+    // stamped with t_ns). Channel count handling matches CsvFloatParser::parse_block.
+    // The packet sequence number goes to blk.seq (16-bit).
+    // Returns the number of rejected packets (bad CRC/header/channel count).
+    size_t decode_block(std::string_view chunk, uint64_t t_ns, FrameBlock& blk);
+    void clear();
+
+    // Frames missing according to the sequence counter since the last clear().
+    uint64_t lost() const { return lost_; }
+    uint16_t last_seq() const { return last_seq_; }
+
+    static uint16_t crc16(const uint8_t* p, size_t n);
+
+    // Appends one COBS-encoded packet including the 0x00 delimiter to `out`.
+    static void encode_frame(uint16_t seq, BinaryEncoding enc, const float* x, size_t n, std::string& out);
+
+private:
+    bool decode_packet(uint64_t t_ns, FrameBlock& blk);
+
+    std::vector<uint8_t> cobs_;  // encoded bytes of the packet being received
+    std::vector<uint8_t> raw_;   // decoded packet scratch
+    bool synced_ = false;        // a delimiter has been seen since clear()
+    bool overflow_ = false;      // current packet exceeded kMaxPacketBytes
+
+    bool has_seq_ = false;
+    uint16_t last_seq_ = 0;
+    uint64_t lost_ = 0;
+};
+
+// Inspects the first bytes of a stream. Returns Binary once a packet with a
+// valid CRC is found, Csv once a line terminator is found in printable text,
+// Unknown while more bytes are needed.
+WireFormat detect_wire_format(std::string_view head);
+
+}
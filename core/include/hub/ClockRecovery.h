@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "hub/Frame.h"
+
+namespace hub {
+
+// Recovers the sample clock of a device that sends no timestamps.
+//
+// Each block is one burst that arrived at blk.t_ns (host clock). A running
+// linear model  t = offset + period * k  over (sample index k, arrival time) is
+// fitted by exponentially weighted least squares (RLS with forgetting), and
+// every frame of the burst gets evenly spaced t_ns from the model. Arrival
+// jitter and the host/device crystal drift are averaged out; the constant part
+// of the transport latency stays in the offset.
+//
+// The sample index advances by the device counter when blk.has_seq (so lost
+// samples keep their slot), otherwise by one per frame.
+class ClockRecovery {
+public:
+    // forget: weight decay per burst (0.99..0.9999); larger = smoother, slower.
+    explicit ClockRecovery(double forget = 0.995) : forget_(forget) {}
+
+    void reset();
+
+    // Rewrites blk.t_ns. Until the model has locked, frames are spread evenly
+    // between the previous and the current arrival time.
+    void apply(FrameBlock& blk);
+
+    bool locked() const { return locked_; }
+    double rate_hz() const { return (locked_ && period_s_ > 0.0) ? 1.0 / period_s_ : 0.0; }
+
+private:
+    void observe(double k, double t_s);
+
+    double forget_;
+
+    bool has_seq_ = false;
+    uint64_t last_seq_ = 0;
+    double k_ = 0.0;            // index of the last frame seen
+    std::vector<double> idx_;   // per-frame index scratch
+
+    uint64_t t0_ns_ = 0;        // host origin of the fit
+    uint64_t prev_arrival_ns_ = 0;
+    uint64_t last_out_ns_ = 0;
+
+    // Centered, exponentially weighted moments of (k, t).
+    size_t n_obs_ = 0;
+    double mk_ = 0.0, mt_ = 0.0;
+    double ckk_ = 0.0, ckt_ = 0.0;
+
+    bool locked_ = false;
+    double period_s_ = 0.0;
+};
+
+}
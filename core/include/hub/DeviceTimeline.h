@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "hub/Frame.h"
+
+namespace hub {
+
+// Tracks the device columns of successive FrameBlocks (see FrameBlock::seq,
+// FrameBlock::dev_t): unwraps counters, counts gaps and lost samples, and maps
+// device time onto the host clock so that t_ns spacing is the device's own.
+//
+// Host anchor: the first frame with device time keeps its host t_ns; later
+// frames get anchor + elapsed device time. A device time that runs backwards
+// (reset/reboot) re-anchors.
+class DeviceTimeline {
+public:
+    void reset();
+
+    // Updates counters from blk and rewrites blk.t_ns when blk.has_dev_t.
+    void apply(FrameBlock& blk);
+
+    // Samples missing according to the counter (or to device time when there
+    // is no counter), number of discontinuities, and counter/clock restarts.
+    uint64_t lost() const { return lost_; }
+    uint64_t gaps() const { return gaps_; }
+    uint64_t resets() const { return resets_; }
+
+    // Device sample period from device time, 0 until known.
+    double period_s() const { return period_s_; }
+
+private:
+    // Returns the counter step (0 for the first sample or a restart).
+    uint64_t track_seq(uint64_t raw, unsigned bits);
+    // steps: sample periods since the previous frame per the counter, 0 if unknown.
+    uint64_t map_time(double raw, unsigned bits, double unit_s, uint64_t host_ns, uint64_t steps);
+
+    bool has_seq_ = false;
+    uint64_t last_seq_ = 0;
+
+    bool has_t_ = false;
+    double last_raw_t_ = 0.0;
+    double t_wrap_base_ = 0.0;
+    double t_anchor_ticks_ = 0.0;
+    uint64_t t_anchor_ns_ = 0;
+    double last_t_s_ = 0.0;
+    double period_s_ = 0.0;
+
+    uint64_t lost_ = 0;
+    uint64_t gaps_ = 0;
+    uint64_t resets_ = 0;
+};
+
+}
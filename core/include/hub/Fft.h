@@ -0,0 +1,55 @@
+#pragma once
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace hub {
+
+// In-place radix-2 complex FFT for one power-of-two size; twiddles and the
+// bit-reversal order are computed once in resize().
+class Fft {
+public:
+    Fft() = default;
+    explicit Fft(size_t n) { resize(n); }
+
+    // n must be a power of two (>= 1).
+    void resize(size_t n);
+    size_t size() const { return n_; }
+
+    void forward(std::complex<double>* x) const;
+    // Inverse transform, scaled by 1/n.
+    void inverse(std::complex<double>* x) const;
+
+    static bool is_pow2(size_t n) { return n != 0 && (n & (n - 1)) == 0; }
+    static size_t next_pow2(size_t n);
+
+private:
+    void run(std::complex<double>* x, bool inv) const;
+
+    size_t n_ = 0;
+    std::vector<std::complex<double>> tw_;   // exp(-2 pi i k / n), k < n/2
+    std::vector<size_t> rev_;
+};
+
+// Real-input FFT: the n samples are packed as n/2 complex values, transformed
+// with one half-size Fft and split into the n/2 + 1 bins DC .. Nyquist.
+class RealFft {
+public:
+    RealFft() = default;
+    explicit RealFft(size_t n) { resize(n); }
+
+    // n must be a power of two (>= 2).
+    void resize(size_t n);
+    size_t size() const { return n_; }
+    size_t bins() const { return n_ / 2 + 1; }
+
+    // x: n samples; X: bins() values, also used as scratch.
+    void forward(const double* x, std::complex<double>* X) const;
+
+private:
+    size_t n_ = 0;
+    Fft half_;
+    std::vector<std::complex<double>> tw_;   // exp(-2 pi i k / n), k <= n/4
+};
+
+}
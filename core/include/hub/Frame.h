@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -9,4 +10,49 @@ struct Frame {
     std::vector<float> x;
 };
 
+// A batch of frames sharing one channel count.
+// x is an n_frames x n_ch matrix stored frame-major (row i = frame i), so the
+// channels of one frame are contiguous. Storage is kept across clear() calls;
+// only n_frames and the device column flags are reset.
+struct FrameBlock {
+    size_t n_ch = 0;
+    size_t n_frames = 0;
+    std::vector<float> x;
+    std::vector<uint64_t> t_ns;
+
+    // Optional device columns, one entry per frame when the flag is set by the
+    // producer (set it before append()). Counters wrap at 2^bits, 0 = never.
+    bool has_seq = false;
+    unsigned seq_bits = 0;
+    std::vector<uint64_t> seq;
+
+    bool has_dev_t = false;
+    unsigned dev_t_bits = 0;
+    double dev_t_unit_s = 1e-6;   // seconds per device time tick
+    std::vector<double> dev_t;    // raw device time in ticks
+
+    void clear() {
+        n_frames = 0;
+        has_seq = false;
+        has_dev_t = false;
+    }
+
+    float* row(size_t i) { return x.data() + i * n_ch; }
+    const float* row(size_t i) const { return x.data() + i * n_ch; }
+
+    float* append(uint64_t t) {
+        size_t need = (n_frames + 1) * n_ch;
+        if (x.size() < need) x.resize(need > 2 * x.size() ? need : 2 * x.size());
+        if (t_ns.size() < n_frames + 1) t_ns.resize(2 * n_frames + 1);
+        if (has_seq && seq.size() < n_frames + 1) seq.resize(2 * n_frames + 1);
+        if (has_dev_t && dev_t.size() < n_frames + 1) dev_t.resize(2 * n_frames + 1);
+        t_ns[n_frames] = t;
+        return row(n_frames++);
+    }
+
+    void pop_back() {
+        if (n_frames > 0) --n_frames;
+    }
+};
+
 }
@@ -10,8 +10,24 @@ public:
     std::vector<std::string> push(std::string_view chunk);
     void clear();
 
+    // Zero-copy framing:
+    //   framer.feed(chunk);
+    //   std::string_view line;
+    //   while (framer.next(line)) { ... }
+    //
+    // Lines that lie completely inside `chunk` are returned as views into it, so
+    // `chunk` must stay alive until next() returns false. Only a line that spans
+    // two chunks is assembled in the internal carry buffer. A returned view is
+    // valid until the following next()/feed()/clear() call.
+    void feed(std::string_view chunk);
+    bool next(std::string_view& line);
+
 private:
-    std::string buf_;
+    std::string buf_;        // partial line carried over from the previous chunk
+    std::string_view cur_;   // chunk currently being framed
+    size_t pos_ = 0;         // read position inside cur_
+    bool drop_buf_ = false;  // buf_ was handed out as a line; clear on next call
+    bool pending_cr_ = false;
 };
 
 }
@@ -1,13 +1,57 @@
 #pragma once
+#include <cstddef>
 #include <optional>
 #include <string_view>
 #include <vector>
 
+#include "hub/Frame.h"
+#include "hub/Framer.h"
+
 namespace hub {
 
+// Optional device columns inside a CSV line. Column indexes count values from
+// 0; -1 means the stream has no such column. Device columns are read exactly
+// (double precision) and are not part of the channel data.
+struct CsvLayout {
+    int seq_col = -1;           // device sample counter
+    unsigned seq_bits = 0;      // counter width for wrap-around, 0 = never wraps
+
+    int time_col = -1;          // device timestamp
+    unsigned time_bits = 0;     // timestamp width in ticks, 0 = never wraps
+    double time_unit_s = 1e-6;  // seconds per tick (micros() by default)
+
+    bool has_device_columns() const { return seq_col >= 0 || time_col >= 0; }
+};
+
 class CsvFloatParser {
 public:
+    // Scratch size parse_block() uses for lines whose width it does not know
+    // yet (the first line, device-column lines). Wider lines are still
+    // accepted, as parse_line() accepts them, through a slower path that
+    // allocates.
+    static constexpr size_t kMaxValues = 512;
+
     std::optional<std::vector<float>> parse_line(std::string_view line) const;
+
+    // Allocation-free variant of parse_line(): accepts the same formats and yields
+    // the same values, written to out[0..n). Returns n, or 0 if the line is
+    // malformed or holds more than `cap` values (any cap; parse_line() has none,
+    // so size out for the widest line expected).
+    size_t parse_into(std::string_view line, float* out, size_t cap) const;
+
+    // Drains every complete line from `framer` into `blk`, one row per line, each
+    // stamped with t_ns. If blk.n_ch is 0 the first good line fixes it; lines with
+    // a different channel count are rejected. Returns the number of rejected lines.
+    // Device columns from the layout go to blk.seq / blk.dev_t.
+    size_t parse_block(LineFramer& framer, uint64_t t_ns, FrameBlock& blk) const;
+
+    void set_layout(const CsvLayout& layout) { layout_ = layout; }
+    const CsvLayout& layout() const { return layout_; }
+
+private:
+    size_t parse_block_with_columns(LineFramer& framer, uint64_t t_ns, FrameBlock& blk) const;
+
+    CsvLayout layout_{};
 };
 
 }
@@ -2,13 +2,71 @@
 #define HUB_PIPELINE_H
 
 #include <cstdint>
+#include <string>
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include "hub/Frame.h"
 #include "hub/filters/Bias.h"
+#include "hub/filters/EMA.h"
+#include "hub/filters/Fir.h"
+#include "hub/filters/MA.h"
+#include "hub/filters/Median.h"
+#include "hub/filters/Sos.h"
 
 namespace hub {
 
+enum class StageKind : int {
+    MA = 0,
+    EMA = 1,
+    Notch = 2,
+    Bias = 3,   // capture point and stored-bias subtraction (at most once)
+    Iir = 4,    // designed low/high/band-pass (hub::design_iir)
+    Fir = 5,    // kernel file or windowed-sinc design (hub::FirFilter)
+    Median = 6, // sliding median (hub::MedianFilter)
+    Hampel = 7, // spike rejection (hub::HampelFilter)
+};
+
+// One stage of the chain. Only the fields of its kind are used; notch, IIR and
+// designed FIR take fs_hz from the PipelineConfig.
+struct StageSpec {
+    StageKind kind = StageKind::MA;
+    size_t ma_win = 5;
+    float ema_alpha = 0.2f;
+    double notch_f0 = 60.0;
+    double notch_q = 30.0;
+    int notch_harmonics = 1;    // > 1: hum bank (hub::design_hum_bank)
+
+    FilterBand iir_band = FilterBand::LowPass;
+    int iir_order = 2;
+    double iir_f1 = 10.0;
+    double iir_f2 = 0.0;        // band-pass upper edge
+    double iir_ripple_db = 0.0; // 0 = Butterworth, > 0 = Chebyshev I
+
+    std::string fir_path;       // kernel file; empty = design from the fields below
+    std::vector<double> fir_kernel;     // loaded from fir_path by parse_stage_chain
+    FilterBand fir_band = FilterBand::LowPass;
+    size_t fir_taps = 101;
+    double fir_f1 = 10.0;
+    double fir_f2 = 0.0;
+
+    size_t med_win = 5;         // median and Hampel window
+    float hampel_k = 3.0f;      // Hampel threshold in robust standard deviations
+};
+
+// Chain spec: comma-separated stages, run left to right, e.g.
+// "ma:5, ema:0.2, notch:60:30, bias". Stages may repeat, except bias.
+//   ma:N  ema:A  notch:F0[:Q]  bias
+//   hum:F0[:HARMONICS[:Q]]     notch bank on F0 and its harmonics (default 4)
+//   lp:FC[:ORDER[:RIPPLE_DB]]  hp:FC[:ORDER[:RIPPLE_DB]]  bp:F1:F2[:ORDER[:RIPPLE_DB]]
+//   fir:PATH                   kernel file (hub::load_fir_kernel), read here
+//   firlp:FC[:TAPS]  firhp:FC[:TAPS]  firbp:F1:F2[:TAPS]   windowed sinc
+//   median:W  hampel:W[:K]     sliding median; spikes beyond K (default 3) sigma
+// IIR order defaults to 2; a ripple selects Chebyshev I. FIR taps default to
+// 101. Returns false with a message in err.
+bool parse_stage_chain(const std::string& spec, std::vector<StageSpec>& out, std::string& err);
+std::string format_stage_chain(const std::vector<StageSpec>& stages);
+
 struct PipelineConfig {
     bool enable_ma = false;
     size_t ma_win = 5;
@@ -20,19 +78,27 @@ struct PipelineConfig {
     double fs_hz = 200.0;
     double notch_f0 = 60.0;
     double notch_q = 30.0;
+    int notch_harmonics = 1;    // also notch 2*f0, 3*f0, ... up to this many
 
     bool enable_bias = false;
-};
 
-struct Frame {
-    uint64_t t_ns = 0;
-    std::vector<float> x;
+    // Explicit chain. When non-empty it replaces the enable_* flags above,
+    // which otherwise give the fixed order MA, EMA, notch, bias.
+    std::vector<StageSpec> stages;
 };
 
 struct PipelineOut {
     Frame frame;
 };
 
+// Instruction set used by Pipeline::process_block() (x86 only; other targets
+// always run the scalar code). All levels give bit-identical results.
+enum class SimdLevel : int {
+    Scalar = 0,
+    Sse2 = 1,
+    Avx2 = 2,
+};
+
 class Pipeline {
 public:
     void reset();
@@ -42,6 +108,28 @@ public:
 
     PipelineOut process(uint64_t t_ns, const std::vector<float>& in);
 
+    // One frame of n channels, filtered in place or into caller storage (out
+    // may alias in). No heap allocation once the channel count is settled.
+    void process(float* x, size_t n);
+    void process(const float* in, float* out, size_t n);
+
+    // Runs every row of blk through the chain in place (same results as calling
+    // process() row by row), vectorized across channels.
+    void process_block(FrameBlock& blk);
+
+    // Highest level this CPU supports, and an upper limit for this pipeline
+    // (benchmarks / comparisons). Defaults to the detected level.
+    static SimdLevel detected_simd();
+    void set_simd(SimdLevel level);
+    SimdLevel simd() const { return simd_; }
+
+    // The chain in effect after set_config().
+    const std::vector<StageSpec>& stages() const { return specs_; }
+
+    // Group delay of the MA, median and FIR stages in frames (FIR block latency
+    // included); BleWorker shifts frameReady timestamps back by it.
+    double delay_frames() const { return delay_; }
+
     void begin_bias_capture(size_t frames);
 
     bool bias_has() const { return bias_.has_bias(); }
@@ -49,29 +137,35 @@ public:
     const std::vector<float>& bias_vec() const { return bias_.bias(); }
 
 private:
-    void ensure_ma();
-    void ensure_ema();
-    void ensure_notch();
-    void update_notch_coeff();
+    struct Stage {
+        StageSpec spec;
+        MAFilter ma;
+        EMAFilter ema;
+        SosFilter sos;      // notch and IIR
+        FirFilter fir;
+        MedianFilter median;
+        HampelFilter hampel;
+        std::vector<double> fir_kernel;     // file kernel or design at fs_hz
+    };
+
+    void configure_stage(Stage& st);
+    void prepare(size_t n_ch);
+    void process_row(float* x);
+    bool process_fused(FrameBlock& blk);
 
 private:
     PipelineConfig cfg_{};
     size_t n_ch_ = 0;
+    SimdLevel simd_ = detected_simd();
 
-    // MA ring
-    bool ma_inited_ = false;
-    size_t ma_pos_ = 0;
-    std::vector<float> ma_ring_;     // size = n_ch * ma_win
-    std::vector<double> ma_sum_;     // size = n_ch
+    std::vector<StageSpec> specs_;
+    std::vector<Stage> stages_;
 
-    // EMA
-    bool ema_inited_ = false;
-    std::vector<float> ema_state_;   // size = n_ch
+    // Chains that are a subset of MA, EMA, one notch or IIR, bias in that
+    // order run through a kernel specialized for exactly that chain.
+    int fused_mask_ = -1;      // bit per position in that order, -1 = generic path
 
-    // Notch biquad
-    bool notch_inited_ = false;
-    double b0_=1,b1_=0,b2_=0,a1_=0,a2_=0;
-    std::vector<double> nx1_, nx2_, ny1_, ny2_; // per channel
+    double delay_ = 0.0;
 
     // Bias
     BiasCorrector bias_;
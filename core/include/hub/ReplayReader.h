@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "hub/Parser.h"
+#include "hub/SpscRing.h"
+
+namespace hub {
+
+struct ReplayConfig {
+    double speed = 1.0;             // 1 = real time, N = N times faster, 0 = as fast as possible
+    bool loop = false;              // start over at the end of the file
+    double raw_bytes_per_s = 0.0;   // pacing of raw captures at speed 1; 0 = as fast as possible
+    size_t chunk = 4096;            // upper bound for a single ring write
+};
+
+enum class ReplayFormat : int {
+    Recording = 0,   // CSV written by the recorder: "t,ch0,ch1,..." header, t in seconds
+    Raw = 1,         // bytes exactly as a transport delivered them (CSV text or binary)
+};
+
+// Plays a file back into an SpscByteRing on its own thread, so it enters the
+// ingest path exactly like a live transport (see SerialReader).
+//
+// Recordings are paced by their t column and passed through unchanged; parse
+// them with recording_layout() so t becomes device time. Raw captures are
+// paced by raw_bytes_per_s.
+//
+// When paced, a full ring drops bytes (counted as overflow) like a live device
+// would. As fast as possible, the reader waits for the consumer instead, so
+// the replay rate is the sustainable throughput of the ingest path.
+class ReplayReader {
+public:
+    using DataFn = std::function<void()>;
+    using EndFn = std::function<void()>;
+
+    ReplayReader() = default;
+    ~ReplayReader();
+
+    ReplayReader(const ReplayReader&) = delete;
+    ReplayReader& operator=(const ReplayReader&) = delete;
+
+    bool open(const std::string& path, const ReplayConfig& cfg, std::string& err);
+
+    // Starts the reader thread. on_data runs after each commit to the ring,
+    // on_end once when the file is exhausted (not when closed); both on the
+    // reader thread.
+    void start(SpscByteRing& ring, DataFn on_data, EndFn on_end);
+
+    void close();
+
+    bool is_open() const { return open_; }
+    const std::string& path() const { return path_; }
+    ReplayFormat format() const { return format_; }
+
+    // Bytes handed to the ring so far (dropped bytes included).
+    uint64_t bytes_sent() const { return sent_.load(std::memory_order_relaxed); }
+    bool finished() const { return finished_.load(); }
+
+    // Parser layout for ReplayFormat::Recording.
+    static CsvLayout recording_layout();
+
+private:
+    void run();
+    bool next_record(std::string& rec, double& t_s);
+    bool rewind();
+    void flush(std::string& batch);
+
+    std::string path_;
+    ReplayConfig cfg_{};
+    ReplayFormat format_ = ReplayFormat::Raw;
+    bool open_ = false;
+
+    std::ifstream in_;
+    std::streampos data_pos_{0};   // first byte after the recording header
+    std::string line_;
+
+    // Recording time of the first and last record, and the offset added to
+    // t on every loop so that time keeps increasing.
+    double first_t_ = 0.0;
+    bool has_first_ = false;
+    double last_t_ = 0.0;
+    double last_dt_ = 0.0;
+    double loop_offset_ = 0.0;
+    uint64_t raw_pos_ = 0;
+
+    bool paced_ = false;
+    SpscByteRing* ring_ = nullptr;
+    DataFn on_data_;
+    EndFn on_end_;
+
+    std::atomic<uint64_t> sent_{0};
+    std::atomic<bool> finished_{false};
+    std::atomic<bool> run_{false};
+    std::thread thread_;
+};
+
+}
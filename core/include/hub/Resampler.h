@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "hub/Frame.h"
+
+namespace hub {
+
+enum class ResampleMethod : int {
+    Linear = 0,
+    Sinc = 1,       // Hann-windowed sinc, weights normalized per output frame
+};
+
+struct ResamplerConfig {
+    double fs_hz = 200.0;       // output grid rate
+    ResampleMethod method = ResampleMethod::Linear;
+    int half_width = 8;         // sinc: kernel half width in input periods
+    double max_gap_s = 0.25;    // no output inside longer input gaps
+};
+
+// Turns frames with irregular t_ns into frames on the uniform grid
+// t = k / fs_hz (k integer, on the input clock), so streams resampled at the
+// same rate share their timestamps exactly.
+//
+// Linear interpolates between the frames around each grid time and emits it as
+// soon as a frame at or past it arrives. Sinc weights the frames within
+// half_width periods of the grid time (the period is the larger of input and
+// output, so downsampling is anti-aliased) and waits for that much input past
+// it. Each frame is weighted by the spacing around it and the weights are
+// normalized, which keeps DC exact; the kernel still assumes near-uniform input
+// (device time or a recovered clock), so prefer Linear on jittery timestamps.
+// Grid times inside a gap longer than max_gap_s are skipped; output resumes
+// with the first grid time after it.
+class Resampler {
+public:
+    void reset();
+    void configure(const ResamplerConfig& cfg);
+    const ResamplerConfig& config() const { return cfg_; }
+
+    // Appends to out the grid frames completed by the rows of in. Frames not
+    // newer than the previous one are dropped. Device columns are not carried.
+    void process(const FrameBlock& in, FrameBlock& out);
+
+    // How long after a grid time the input must reach before it is emitted:
+    // about one input period (linear) or the kernel half width (sinc).
+    double latency_s() const;
+
+    uint64_t grid_time(uint64_t k) const;
+
+private:
+    void push(uint64_t t, const float* x, FrameBlock& out);
+    void emit_until(uint64_t t_limit, FrameBlock& out);
+    void interpolate(uint64_t tau, float* y);
+    uint64_t first_grid_at_or_after(uint64_t t) const;
+    double reach_ns() const;
+
+    ResamplerConfig cfg_{};
+    double period_ns_ = 5e6;
+    uint64_t whole_ns_ = 5000000;   // period split for exact grid times
+    double frac_ns_ = 0.0;
+    double in_period_ns_ = 5e6;     // running estimate of the input spacing
+
+    size_t n_ch_ = 0;
+    uint64_t next_k_ = 0;           // next grid index to emit
+    bool started_ = false;
+
+    // Recent input, oldest first from first_.
+    FrameBlock buf_;
+    size_t first_ = 0;
+    std::vector<double> acc_;
+};
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "hub/SpscRing.h"
+
+namespace hub {
+
+struct SerialConfig {
+    uint32_t baud = 115200;
+    size_t read_chunk = 4096;   // upper bound for a single OS read
+    bool low_latency = true;    // return bytes as soon as they arrive
+};
+
+// Native serial port reader running on its own thread. Bytes are read straight
+// into the free space of an SpscByteRing (no intermediate buffers); when the
+// ring is full the port is still drained and the bytes are counted as overflow.
+//
+// Port names may be given as reported by the OS enumerator ("COM7", "ttyACM0")
+// or as full paths ("/dev/ttyACM0", "\\\\.\\COM7").
+class SerialReader {
+public:
+    using DataFn = std::function<void()>;
+    using ErrorFn = std::function<void(const std::string&)>;
+
+    SerialReader() = default;
+    ~SerialReader();
+
+    SerialReader(const SerialReader&) = delete;
+    SerialReader& operator=(const SerialReader&) = delete;
+
+    bool open(const std::string& port, const SerialConfig& cfg, std::string& err);
+
+    // Starts the reader thread. on_data runs after each commit to the ring,
+    // on_error once if the port fails (unplug etc.); both on the reader thread.
+    void start(SpscByteRing& ring, DataFn on_data, ErrorFn on_error);
+
+    void close();
+
+    bool is_open() const { return open_; }
+    const std::string& port() const { return port_; }
+
+private:
+    void run();
+    bool read_some(char* dst, size_t cap, size_t& got, std::string& err);
+
+    std::string port_;
+    SerialConfig cfg_{};
+    bool open_ = false;
+
+#ifdef _WIN32
+    void* handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+
+    SpscByteRing* ring_ = nullptr;
+    DataFn on_data_;
+    ErrorFn on_error_;
+
+    std::atomic<bool> run_{false};
+    std::thread thread_;
+};
+
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hub/BinaryFramer.h"
+#include "hub/Parser.h"
+#include "hub/SpscRing.h"
+#include "hub/model/BruteForce_16x2.h"
+
+namespace hub {
+
+struct SimConfig {
+    double fs_hz = 105.0;
+    size_t frames_per_packet = 1;    // frames sent together (BLE notifications batch several)
+    WireFormat wire = WireFormat::Csv;
+
+    // Moving point charge, potential q / |r - s_j| at sensor j (see
+    // BruteForce_16x2Solver). The path is a Lissajous figure over the pad.
+    double charge = 0.05;            // q in volt-metres
+    double path_x_m = 0.03;
+    double path_y_m = 0.03;
+    double path_z_m = 0.04;          // mean height
+    double path_dz_m = 0.01;
+    double path_hz = 0.25;
+
+    // Sensor front end: first-order high-pass with time constant R*C in
+    // sample periods, the solver's per-sample RC_R * RC_C. 0 = DC coupled.
+    // The charge appears at t = 0: the front end starts at rest, so the first
+    // frame carries the step to its potential.
+    double rc_samples = 0.05;
+
+    double noise_rms = 0.002;        // white noise per sample
+    double hum_amp = 0.01;           // mains pickup
+    double hum_hz = 60.0;
+    double drift_rms = 0.001;        // random walk per sqrt(second)
+    double loss = 0.0;               // probability that a packet is dropped
+
+    uint32_t seed = 1;
+};
+
+// Synthetic 16-channel sensor pad with known ground truth. Produces the byte
+// stream a device would send: CSV lines "seq,t_us,ch0..ch15" (parse with
+// csv_layout()) or binary Float32 packets.
+class SensorArraySimulator {
+public:
+    static constexpr int NSENS = BruteForce_16x2Solver::NSENS;
+
+    void reset(const SimConfig& cfg);
+    const SimConfig& config() const { return cfg_; }
+
+    // Appends the next packet (frames_per_packet frames) to out, or nothing if
+    // the packet is lost. Returns the frames generated.
+    size_t next_packet(std::string& out);
+
+    // Stream time of the next frame.
+    double time_s() const { return (double)k_ / cfg_.fs_hz; }
+
+    // Ground truth.
+    Vec3d position(double t_s) const;
+    uint64_t frames() const { return k_; }
+    uint64_t dropped_frames() const { return dropped_; }
+
+    // Parser layout for the CSV stream.
+    static CsvLayout csv_layout();
+
+private:
+    void frame(float* x);
+
+    SimConfig cfg_{};
+    std::array<Vec3d, NSENS> sensors_{};
+
+    std::mt19937 rng_;
+    std::normal_distribution<double> gauss_{0.0, 1.0};
+    std::uniform_real_distribution<double> uni_{0.0, 1.0};
+
+    uint64_t k_ = 0;
+    uint64_t dropped_ = 0;
+
+    double u_prev_[NSENS]{};   // potential before the high-pass
+    double v_prev_[NSENS]{};
+    double drift_[NSENS]{};
+    double hum_phase_[NSENS]{};
+
+    std::vector<float> rows_;
+};
+
+// Runs a SensorArraySimulator on its own thread and writes its stream into an
+// SpscByteRing like a live transport. speed as in ReplayConfig: 1 = real time,
+// N = N times faster, 0 = as fast as the consumer takes it.
+class SimulatorReader {
+public:
+    using DataFn = std::function<void()>;
+
+    SimulatorReader() = default;
+    ~SimulatorReader();
+
+    SimulatorReader(const SimulatorReader&) = delete;
+    SimulatorReader& operator=(const SimulatorReader&) = delete;
+
+    void start(const SimConfig& cfg, double speed, SpscByteRing& ring, DataFn on_data);
+    void close();
+
+    bool is_open() const { return thread_.joinable(); }
+
+    uint64_t frames() const { return frames_.load(std::memory_order_relaxed); }
+    uint64_t dropped_frames() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void flush(std::string& out);
+
+    SensorArraySimulator sim_;
+    double speed_ = 1.0;
+
+    SpscByteRing* ring_ = nullptr;
+    DataFn on_data_;
+
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> run_{false};
+    std::thread thread_;
+};
+
+}
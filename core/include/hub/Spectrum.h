@@ -0,0 +1,82 @@
+#pragma once
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "hub/Fft.h"
+#include "hub/Frame.h"
+
+namespace hub {
+
+enum class SpectrumWindow : int {
+    Hann = 0,
+    Hamming = 1,
+    Blackman = 2,
+    Rect = 3,
+};
+
+struct SpectrumConfig {
+    size_t fft_size = 256;      // frames per segment, power of two
+    size_t hop = 128;           // frames between segments (fft_size - overlap)
+    size_t average = 8;         // Welch: newest periodograms averaged
+    SpectrumWindow window = SpectrumWindow::Hann;
+    bool detrend = true;        // remove the segment mean before windowing
+    double fs_hz = 200.0;       // bin spacing and density scaling
+};
+
+// Streaming short-time spectra of every channel.
+//
+// Frames go into a ring of fft_size rows per channel. Every hop frames (once
+// the ring is full) each channel's segment is windowed and transformed with a
+// real FFT into a one-sided periodogram in units^2/Hz. welch() averages the
+// newest `average` of them, which is the Welch PSD with
+// (fft_size - hop) / fft_size overlap.
+class SpectrumAnalyzer {
+public:
+    void configure(size_t n_ch, const SpectrumConfig& cfg);
+    void reset();
+
+    // Returns the number of segments the block completed.
+    size_t push(const FrameBlock& blk);
+
+    size_t n_ch() const { return n_ch_; }
+    size_t bins() const { return fft_.bins(); }
+    double bin_hz() const { return cfg_.fs_hz / (double)fft_.size(); }
+    const SpectrumConfig& config() const { return cfg_; }
+
+    uint64_t segments() const { return segments_; }
+    size_t averaged() const { return hist_fill_; }
+
+    // Newest periodogram, n_ch x bins, channel-major.
+    const std::vector<float>& periodogram() const { return last_; }
+
+    // Welch PSD, n_ch x bins, channel-major; zeros before the first segment.
+    void welch(std::vector<float>& out) const;
+
+private:
+    void segment();
+
+    SpectrumConfig cfg_{};
+    size_t n_ch_ = 0;
+
+    RealFft fft_;
+    std::vector<double> win_;
+    double scale_ = 0.0;             // 1 / (fs * sum w^2)
+
+    std::vector<float> ring_;        // n_ch x fft_size, channel-major
+    size_t pos_ = 0;                 // next ring row
+    size_t fill_ = 0;
+    size_t since_ = 0;               // frames since the last segment
+
+    std::vector<double> seg_;
+    std::vector<std::complex<double>> spec_;
+
+    std::vector<float> hist_;        // average x n_ch x bins
+    size_t hist_pos_ = 0;
+    size_t hist_fill_ = 0;
+    std::vector<float> last_;
+    uint64_t segments_ = 0;
+};
+
+}
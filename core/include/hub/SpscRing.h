@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hub {
+
+// Bounded lock-free byte ring for exactly one producer thread and one consumer
+// thread. Positions are free-running counters; capacity is a power of two.
+//
+// Producer: write(), or write_span()/commit() to fill the ring in place.
+// Consumer: read_span()/consume().
+// reset() must not race with either side.
+class SpscByteRing {
+public:
+    explicit SpscByteRing(size_t capacity = 1u << 20);
+
+    void reset();
+
+    size_t capacity() const { return buf_.size(); }
+    size_t size() const;
+
+    // Producer: copies all n bytes or none. A rejected write counts as overflow.
+    bool write(const void* data, size_t n);
+
+    // Producer: contiguous free region starting at p (may be shorter than the
+    // total free space when it wraps). Publish with commit().
+    size_t write_span(char*& p);
+    void commit(size_t n);
+    void note_overflow(size_t n);
+
+    // Consumer: contiguous readable region starting at p. Release with consume().
+    size_t read_span(const char*& p) const;
+    void consume(size_t n);
+
+    uint64_t overflow_events() const { return overflow_events_.load(std::memory_order_relaxed); }
+    uint64_t overflow_bytes() const { return overflow_bytes_.load(std::memory_order_relaxed); }
+    size_t high_water() const { return high_water_.load(std::memory_order_relaxed); }
+
+private:
+    void update_high_water(size_t used);
+
+    std::vector<char> buf_;
+    size_t mask_ = 0;
+
+    alignas(64) std::atomic<size_t> head_{0};   // bytes written (producer-owned)
+    alignas(64) std::atomic<size_t> tail_{0};   // bytes read (consumer-owned)
+
+    alignas(64) std::atomic<uint64_t> overflow_events_{0};
+    std::atomic<uint64_t> overflow_bytes_{0};
+    std::atomic<size_t> high_water_{0};
+};
+
+}
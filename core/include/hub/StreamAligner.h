@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "hub/Frame.h"
+
+namespace hub {
+
+// Merges frames from several devices into one time-aligned stream.
+//
+// The first active source is the reference: every one of its frames produces
+// one merged frame at its t_ns, with the channels of all active sources
+// concatenated in source order. The other sources are linearly interpolated
+// at that time. A merged frame waits until every other source has a frame at
+// or after its time, or until it is older than max_wait behind the newest
+// frame seen (a stalled source then holds its last value).
+//
+// Sources join the merged layout with their first frame. All timestamps must
+// come from the same host clock.
+class StreamAligner {
+public:
+    explicit StreamAligner(uint64_t max_wait_ns = 100000000ULL) : max_wait_ns_(max_wait_ns) {}
+
+    void reset();
+
+    // Returns a source id; ids of removed sources are reused.
+    size_t add_source();
+    void remove_source(size_t id);
+    size_t active_sources() const;
+
+    void push(size_t id, uint64_t t_ns, const float* x, size_t n);
+
+    // Next merged frame, if one is ready.
+    bool pop(Frame& out);
+
+    // Channel offset of a source inside merged frames, and the total width.
+    size_t offset_of(size_t id) const;
+    size_t n_ch() const;
+
+private:
+    struct Source {
+        bool active = false;
+        size_t n_ch = 0;
+        std::deque<Frame> q;
+        Frame last;            // last consumed frame, for hold/interpolation
+        bool has_last = false;
+    };
+
+    int reference() const;
+    void sample_at(Source& s, uint64_t t, float* out);
+
+    std::vector<Source> src_;
+    uint64_t newest_ns_ = 0;
+    uint64_t max_wait_ns_;
+};
+
+}
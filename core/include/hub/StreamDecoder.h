@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "hub/BinaryFramer.h"
+#include "hub/ClockRecovery.h"
+#include "hub/DeviceTimeline.h"
+#include "hub/Frame.h"
+#include "hub/Framer.h"
+#include "hub/Parser.h"
+
+namespace hub {
+
+// Byte stream -> timestamped FrameBlock, as used by every transport:
+// wire format detection (CSV text or binary packets), framing and parsing,
+// then device time (DeviceTimeline) or recovered clock (ClockRecovery) for t_ns.
+//
+// One instance per stream; feed chunks in order from a single thread.
+class StreamDecoder {
+public:
+    // Starts a new stream. The CSV layout takes effect here.
+    void reset();
+
+    void set_layout(const CsvLayout& layout) { layout_ = layout; }
+
+    // Streams that may start mid-line (serial ports, raw captures): drop the
+    // bytes up to the first newline of a CSV stream. Binary packets resync on
+    // their own.
+    void set_line_sync(bool on) { line_sync_ = on; }
+
+    // Decodes chunk (arrived at t_ns) into blk. blk is cleared; its n_ch is kept
+    // (0 lets the first good row fix it). Returns the number of rejected rows.
+    size_t decode(std::string_view chunk, uint64_t t_ns, FrameBlock& blk);
+
+    WireFormat wire() const { return wire_; }
+
+    // True once after decode() has decided the wire format.
+    bool take_wire_detected();
+
+    // Sample rate from device time when the stream has it, else from clock
+    // recovery; 0 until known.
+    double rate_hz() const;
+
+    uint64_t lost() const { return timeline_.lost(); }
+
+private:
+    CsvLayout layout_{};
+    bool line_sync_ = false;
+
+    WireFormat wire_ = WireFormat::Unknown;
+    bool wire_event_ = false;
+    bool synced_ = false;
+    std::string detect_buf_;      // first bytes, until the wire format is known
+
+    BinaryFrameDecoder bin_;
+    LineFramer framer_;
+    CsvFloatParser parser_;
+
+    DeviceTimeline timeline_;     // device seq/time -> gaps, t_ns
+    ClockRecovery clock_;         // t_ns for streams without device time
+    bool dev_time_ = false;       // last block carried device time
+};
+
+}
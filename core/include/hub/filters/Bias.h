@@ -19,6 +19,10 @@ public:
     void update_capture(const std::vector<float>& x);
     void apply_inplace(std::vector<float>& x) const;
 
+    // Same for one frame of n channels (e.g. a FrameBlock row).
+    void update_capture(const float* x, size_t n);
+    void apply_inplace(float* x, size_t n) const;
+
     const std::vector<float>& bias() const { return bias_; }
     size_t n_ch() const { return n_ch_; }
 
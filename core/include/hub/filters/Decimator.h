@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "hub/Frame.h"
+
+namespace hub {
+
+// Anti-aliased decimation by an integer factor M, per channel. A low-pass FIR
+// (windowed sinc at fs / 2M) is evaluated only for the kept frames, in
+// polyphase order: every input frame adds its products to the outputs still
+// pending, about taps / M multiply-adds per channel, spread evenly over the
+// frames. Output m belongs to input frame m * M, counted from the first frame,
+// and lags it by the filter's group delay, (taps - 1) / 2 input frames. The
+// history starts filled with the first frame.
+class Decimator {
+public:
+    // taps = 0 picks 20 * factor + 1. Factor 1 passes frames through.
+    void reset();
+    void configure(size_t n_ch, size_t factor, size_t taps = 0);
+
+    // One input frame. Returns true and writes out (n_ch values, may alias x)
+    // when it completes an output frame.
+    bool push(const float* x, float* out);
+
+    // Appends the output frames completed by the rows of in to out, each with
+    // the timestamp of the input frame that completed it. Device columns are
+    // not carried over.
+    void process(const FrameBlock& in, FrameBlock& out);
+
+    size_t n_ch() const { return n_ch_; }
+    size_t factor() const { return factor_; }
+    size_t taps() const { return h_.size(); }
+    // In input frames.
+    double delay() const { return factor_ > 1 ? 0.5 * (double)(h_.size() - 1) : 0.0; }
+    bool ready() const { return ready_; }
+
+private:
+    void prime(const float* x);
+
+    bool ready_ = false;
+    bool primed_ = false;
+    size_t n_ch_ = 0;
+    size_t factor_ = 1;
+    std::vector<double> h_;
+    size_t phase_ = 0;              // input frame index mod factor_
+    // Pending outputs: n_acc_ rows of n_ch_, the row of the next output first
+    // at head_.
+    size_t n_acc_ = 0;
+    size_t head_ = 0;
+    std::vector<double> acc_;
+};
+
+}
@@ -4,18 +4,23 @@
 
 namespace hub {
 
+// y = alpha * x + (1 - alpha) * y, per channel, starting at the first frame.
 class EMAFilter {
 public:
     void reset();
     void configure(size_t n_ch, float alpha);
     void set_alpha(float alpha);
     void process_inplace(std::vector<float>& x);
+    void process_inplace(float* x, size_t n);
 
     float alpha() const { return alpha_; }
     bool ready() const { return ready_; }
 
 private:
+    friend class Pipeline;   // runs the same arithmetic in its fused kernels
+
     bool ready_ = false;
+    bool primed_ = false;
     size_t n_ch_ = 0;
     float alpha_ = 0.2f;
     std::vector<float> y_;
@@ -0,0 +1,89 @@
+#pragma once
+#include <complex>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "hub/Fft.h"
+#include "hub/filters/Sos.h"
+
+namespace hub {
+
+// Hamming-windowed sinc with taps coefficients (made odd for high/band-pass),
+// unity gain at DC, fs/2 or the band center. Low/high-pass use f1 only.
+// Returns no taps for edges outside (0, fs/2).
+std::vector<double> design_fir(FilterBand band, size_t taps, double fs_hz, double f1_hz, double f2_hz = 0.0);
+
+// Coefficients separated by whitespace, commas or semicolons; '#' starts a
+// comment. Returns false with a message in err.
+bool load_fir_kernel(const std::string& path, std::vector<double>& taps, std::string& err);
+
+// Delay of the kernel in samples: (taps - 1) / 2 when it is symmetric or
+// antisymmetric (linear phase), otherwise its energy centroid.
+double fir_group_delay(const std::vector<double>& taps);
+
+enum class FirMethod : int {
+    Auto = 0,        // cheaper of the two for the kernel length (fir_fft_size)
+    Direct = 1,
+    OverlapSave = 2,
+};
+
+// FFT size Auto uses for a kernel length, 0 when direct form is cheaper.
+size_t fir_fft_size(size_t taps);
+
+// FIR filter per channel. Direct form convolves every frame against a history
+// ring. Overlap-save collects a block of fft_size - taps + 1 frames and
+// convolves it through the FFT (two channels per complex transform), so its
+// output lags by latency() frames on top of the kernel's own group delay.
+// Both start from a history filled with the first frame.
+class FirFilter {
+public:
+    void reset();
+    void configure(size_t n_ch, const std::vector<double>& taps, FirMethod method = FirMethod::Auto);
+
+    void process_inplace(std::vector<float>& x);
+    void process_inplace(float* x, size_t n);
+
+    size_t taps() const { return h_.size(); }
+    const std::vector<double>& kernel() const { return h_; }
+    bool uses_fft() const { return fft_n_ != 0; }
+    size_t fft_size() const { return fft_n_; }
+    // Block latency (0 for direct form), and that plus the group delay.
+    size_t latency() const { return fft_n_ ? hop_ - 1 : 0; }
+    double delay() const { return gd_ + (double)latency(); }
+
+    bool ready() const { return ready_; }
+
+private:
+    friend class Pipeline;
+
+    void prime(const float* x);
+    void run_direct(float* x);
+    void run_fft(float* x);
+    void convolve_block();
+
+    bool ready_ = false;
+    bool primed_ = false;
+    size_t n_ch_ = 0;
+    std::vector<double> h_;
+    double gd_ = 0.0;
+
+    // Direct form: 2 * taps rows, every frame written twice so the last taps
+    // frames are always contiguous.
+    std::vector<double> hr_;        // kernel reversed
+    std::vector<float> hist_;
+    size_t pos_ = 0;
+    std::vector<double> acc_;
+
+    // Overlap-save
+    Fft fft_;
+    size_t fft_n_ = 0;
+    size_t hop_ = 0;                // new frames per block
+    size_t fill_ = 0;               // frames of the current block so far
+    std::vector<std::complex<double>> hf_;    // kernel spectrum
+    std::vector<std::complex<double>> in_;    // per channel pair: taps - 1 old, then hop_ new
+    std::vector<std::complex<double>> work_;
+    std::vector<float> out_;        // last block's output, hop_ rows
+};
+
+}
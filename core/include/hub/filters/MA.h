@@ -4,21 +4,43 @@
 
 namespace hub {
 
+// Moving average over the last win_len frames, per channel. The window starts
+// filled with the first frame, so the output does not ramp up from zero.
+//
+// The running sums are double and updated by the difference of the entering
+// and leaving frame; every resync_interval() frames they are recomputed from
+// the window itself, so rounding error cannot build up over unbounded runtime.
+// That costs at most one extra add per sample.
 class MAFilter {
 public:
+    static constexpr size_t kResyncFrames = 1u << 12;
+    static size_t resync_interval(size_t win_len) { return win_len > kResyncFrames ? win_len : kResyncFrames; }
+
+    // Compensated (Neumaier) sums of win rows of n values, written to sum;
+    // comp is n values of scratch.
+    static void window_sums(const float* ring, size_t n, size_t win, double* sum, double* comp);
+
     void reset();
     void configure(size_t n_ch, size_t win_len);
     void process_inplace(std::vector<float>& x);
+    void process_inplace(float* x, size_t n);
 
     size_t win_len() const { return win_len_; }
     bool ready() const { return ready_; }
 
 private:
+    friend class Pipeline;   // runs the same arithmetic in its fused kernels
+
+    void prime(const float* x);
+
     bool ready_ = false;
+    bool primed_ = false;
     size_t n_ch_ = 0;
     size_t win_len_ = 1;
     size_t idx_ = 0;
-    std::vector<float> sum_;
+    size_t since_resync_ = 0;
+    std::vector<double> sum_;
+    std::vector<double> comp_;
     std::vector<float> ring_;
 };
 
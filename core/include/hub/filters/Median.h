@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace hub {
+
+// Median of the last win values, per channel, updated in O(log win): the
+// window is split into a max-heap of the lower half and a min-heap of the
+// upper half, and each new value takes the heap node of the value it replaces
+// before the two heaps are re-balanced. Even windows give the mean of the two
+// middle values.
+class RunningMedian {
+public:
+    void configure(size_t n_ch, size_t win);
+
+    // Whole window set to x (one value per channel).
+    void fill(const float* x);
+    // Replaces the oldest value of every channel with x and writes the medians
+    // to med (may alias x).
+    void push(const float* x, float* med);
+
+    size_t win() const { return win_; }
+
+private:
+    void sift_up_lo(size_t b, size_t i);
+    void sift_down_lo(size_t b, size_t i);
+    void sift_up_hi(size_t b, size_t i);
+    void sift_down_hi(size_t b, size_t i);
+    void swap_nodes(size_t b, size_t i, size_t j);
+
+    size_t n_ch_ = 0;
+    size_t win_ = 1;
+    size_t n_lo_ = 1;               // lower half (the median for odd windows)
+    size_t idx_ = 0;                // oldest slot
+    // Per channel, win entries each: value per slot, slot per heap node (lower
+    // half first), heap node per slot.
+    std::vector<float> val_;
+    std::vector<size_t> heap_;
+    std::vector<size_t> pos_;
+};
+
+// Sliding median over the last win_len frames. Removes single-frame spikes
+// entirely (win_len >= 3); delays the signal by (win_len - 1) / 2 frames. The
+// window starts filled with the first frame.
+class MedianFilter {
+public:
+    void reset();
+    void configure(size_t n_ch, size_t win_len);
+    void process_inplace(std::vector<float>& x);
+    void process_inplace(float* x, size_t n);
+
+    size_t win_len() const { return med_.win(); }
+    bool ready() const { return ready_; }
+
+private:
+    friend class Pipeline;
+
+    bool ready_ = false;
+    bool primed_ = false;
+    size_t n_ch_ = 0;
+    RunningMedian med_;
+};
+
+// Hampel outlier rejection: a frame is replaced by the median of the last
+// win_len frames when it is more than k robust standard deviations from it.
+// The scale is 1.4826 times the running median of the past absolute
+// deviations. Inliers pass unchanged and undelayed.
+class HampelFilter {
+public:
+    void reset();
+    void configure(size_t n_ch, size_t win_len, float k);
+    void set_threshold(float k) { k_ = k; }
+    void process_inplace(std::vector<float>& x);
+    void process_inplace(float* x, size_t n);
+
+    size_t win_len() const { return med_.win(); }
+    float threshold() const { return k_; }
+    bool ready() const { return ready_; }
+
+private:
+    friend class Pipeline;
+
+    bool ready_ = false;
+    bool primed_ = false;
+    size_t n_ch_ = 0;
+    float k_ = 3.0f;
+    RunningMedian med_;
+    RunningMedian mad_;
+    std::vector<float> m_;      // median
+    std::vector<float> d_;      // absolute deviation from it
+    std::vector<float> s_;      // median of the past deviations
+};
+
+}
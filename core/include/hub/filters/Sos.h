@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace hub {
+
+// One second-order section, a0 normalized to 1:
+// H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+struct Biquad {
+    double b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+};
+
+enum class FilterBand : int {
+    LowPass = 0,
+    HighPass = 1,
+    BandPass = 2,
+};
+
+// Butterworth (ripple_db == 0) or Chebyshev type I (passband ripple in dB)
+// designed through the bilinear transform with prewarped edges, as sections
+// ordered from the poles furthest from the unit circle to the closest.
+// Low/high-pass use f1 only; band-pass runs f1..f2 and has 2 * order poles.
+// Returns no sections for edges outside (0, fs/2) or order < 1.
+std::vector<Biquad> design_iir(FilterBand band, int order, double fs_hz,
+                               double f1_hz, double f2_hz = 0.0, double ripple_db = 0.0);
+
+// RBJ notch at f0 with quality q.
+Biquad design_notch(double fs_hz, double f0_hz, double q);
+
+// Mains hum bank: one notch per harmonic k = 1..harmonics of f0, each with a
+// bandwidth of k * f0 / q (the lines widen with k as the line frequency
+// wanders). Harmonics above fs/2 are notched where they alias to; aliases that
+// coincide with an earlier notch or would reach DC or fs/2 are skipped.
+std::vector<Biquad> design_hum_bank(double fs_hz, double f0_hz, int harmonics, double q);
+
+// Section structure. Transposed direct form II keeps two states per section;
+// direct form I keeps the last two inputs and outputs, and is what the single
+// notch has always run (its output is kept bit for bit).
+enum class SosForm : int {
+    Tdf2 = 0,
+    Df1 = 1,
+};
+
+// Cascade of biquads (double state), per channel.
+class SosFilter {
+public:
+    void reset();
+    void configure(size_t n_ch, const std::vector<Biquad>& sections, SosForm form = SosForm::Tdf2);
+    // New coefficients; the state is kept when the section count is unchanged.
+    void set_sections(const std::vector<Biquad>& sections);
+
+    void process_inplace(std::vector<float>& x);
+    void process_inplace(float* x, size_t n);
+
+    size_t sections() const { return sec_.size(); }
+    SosForm form() const { return form_; }
+    bool ready() const { return ready_; }
+
+private:
+    friend class Pipeline;   // runs the same arithmetic in its fused kernels
+
+    bool ready_ = false;
+    size_t n_ch_ = 0;
+    SosForm form_ = SosForm::Tdf2;
+    std::vector<Biquad> sec_;
+    // Per section: z1[n_ch], z2[n_ch] (Tdf2) or x1, x2, y1, y2 [n_ch] (Df1).
+    std::vector<double> z_;
+};
+
+}
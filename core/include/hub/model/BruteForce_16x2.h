@@ -2,12 +2,16 @@
 #define HUB_MODEL_BRUTEFORCE_16X2_H
 
 #include <array>
+#include <memory>
 #include <vector>
 #include <mutex>
 #include <cstddef>
+#include <cstdint>
 
 namespace hub {
 
+class GridScanPool;
+
 struct Vec3d { double x; double y; double z; };
 
 struct BruteForce_16x2Output {
@@ -26,6 +30,7 @@ public:
     static constexpr int NSENS = 16;
 
     BruteForce_16x2Solver();
+    ~BruteForce_16x2Solver();
     void reset();
 
     // runtime params
@@ -42,14 +47,51 @@ public:
 
     static std::array<Vec3d, NSENS> sensor_positions();
 
+    // The grid scans use AVX2/FMA when the CPU has them; off = scalar path.
+    static bool simd_available();
+    void set_simd(bool on) { simd_ = on && simd_available(); }
+    bool simd() const { return simd_; }
+    size_t grid_size() const { return grid_.size(); }
+
+    // Threads (the caller included) a grid scan is split across; 0 = one per
+    // hardware thread. The workers persist between solves. Grids too small
+    // to share out are still scanned on the calling thread.
+    void set_threads(int n);
+    int threads() const { return threads_; }
+
+    // Coarse-to-fine search instead of the full scan: every 2^L-th point per
+    // axis is scanned, then the top_k best points (and, while tracking, the
+    // previous position) are refined in +-2 point neighbourhoods at half the
+    // spacing per level, down to the grid step. max_evals bounds the points
+    // evaluated per solve and picks L; a grid that fits in it is scanned whole.
+    // The coarse lattice always fits in max_evals and is scanned in full;
+    // refining stops when a solve reaches max_evals.
+    // The pyramid runs on the calling thread and on the scalar kernels.
+    // It can miss the full scan's minimum. On the simulator's stream (grids
+    // down to 1 mm, default noise, hum and drift) top_k 4 missed it on up to
+    // 4% of frames, top_k 16 on up to 1.2% and top_k 1 on up to 10%.
+    void set_pyramid(bool on, int top_k = 4, int max_evals = 4096);
+    bool pyramid() const { return pyramid_; }
+    int pyramid_levels() const { return pyramid_ ? pyr_levels_ : 0; }
+
+    // Grid points evaluated by the last solve.
+    size_t last_evals() const { return last_evals_; }
+
 private:
     struct GridPoint { double x; double y; double z; };
+    struct PyrCand {
+        double err;
+        int idx;
+        bool operator<(const PyrCand& o) const { return err < o.err || (err == o.err && idx < o.idx); }
+    };
 
     static void ensure_sensors();
     static void build_sensors();
     static double dist3(const Vec3d& a, const Vec3d& b);
 
     void rebuild_grid();
+    void plan_pyramid();
+    template <class Eval> int pyramid_search(Eval&& eval, int seed, double& err, double& q1, double& q2);
     int solve_static_idx(const double V[NSENS], Vec3d& out_r, double& out_q, double& out_err);
     int solve_dynamic_idx(const double V1[NSENS], const double V2[NSENS], int idx_r1,
                           Vec3d& out_r2, double& out_q1k, double& out_q2k, double& out_err);
@@ -60,8 +102,36 @@ private:
     static std::once_flag sensors_once_;
     static std::array<Vec3d, NSENS> sensors_;
 
+    // Grid columns, structure-of-arrays: row j < NSENS holds 1/|r - s_j| of
+    // every grid point, rows NSENS and NSENS + 1 hold sum_j (1/|r - s_j|)^2
+    // summed plainly and with fused multiply-adds (see den_row()). Rows are
+    // stride_ long (a multiple of 4, padding zero) and 32-byte aligned.
+    const double* inv_row(int j) const { return inv_buf_.data() + inv_off_ + (size_t)j * stride_; }
+    const double* den_row() const { return inv_row(simd_ ? NSENS + 1 : NSENS); }
+
     std::vector<GridPoint> grid_;
-    std::vector<std::array<double, NSENS>> invR_;
+    int nx_ = 0, ny_ = 0, nz_ = 0;     // grid_[(ix * ny_ + iy) * nz_ + iz]
+    std::vector<double> inv_buf_;
+    size_t inv_off_ = 0;
+    size_t stride_ = 0;
+    bool simd_ = simd_available();
+
+    int scan_parts() const;
+    GridScanPool* pool_for(int parts);
+
+    int threads_ = 1;
+    std::unique_ptr<GridScanPool> pool_;
+
+    bool pyramid_ = false;
+    int pyr_top_k_ = 4;
+    int pyr_max_evals_ = 4096;
+    int pyr_levels_ = 0;
+    std::vector<int> pyr_axis_[3];     // coarse lattice indices along x, y, z
+    std::vector<uint32_t> pyr_seen_;   // == pyr_tag_: evaluated in this solve
+    uint32_t pyr_tag_ = 0;
+    std::vector<PyrCand> pyr_level_;   // candidates of the current level
+    std::vector<int> pyr_centres_;
+    size_t last_evals_ = 0;
 
     double xmin_ = -0.06, xmax_ = 0.06;
     double ymin_ = -0.06, ymax_ = 0.06;
@@ -0,0 +1,253 @@
+#include "hub/BinaryFramer.h"
+#include <array>
+#include <cstring>
+
+namespace hub {
+
+static const std::array<uint16_t, 256>& crc16_table() {
+    static const std::array<uint16_t, 256> table = []() {
+        std::array<uint16_t, 256> t{};
+        for (int i = 0; i < 256; ++i) {
+            uint16_t c = static_cast<uint16_t>(i << 8);
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 0x8000) ? static_cast<uint16_t>((c << 1) ^ 0x1021) : static_cast<uint16_t>(c << 1);
+            }
+            t[(size_t)i] = c;
+        }
+        return t;
+    }();
+    return table;
+}
+
+uint16_t BinaryFrameDecoder::crc16(const uint8_t* p, size_t n) {
+    const auto& t = crc16_table();
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < n; ++i) {
+        crc = static_cast<uint16_t>((crc << 8) ^ t[((crc >> 8) ^ p[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+static bool cobs_decode(const uint8_t* in, size_t n, std::vector<uint8_t>& out) {
+    out.clear();
+    size_t i = 0;
+    while (i < n) {
+        uint8_t code = in[i++];
+        if (code == 0) return false;
+        for (uint8_t k = 1; k < code; ++k) {
+            if (i >= n) return false;
+            out.push_back(in[i++]);
+        }
+        if (code != 0xFF && i < n) out.push_back(0);
+    }
+    return true;
+}
+
+static void cobs_encode(const uint8_t* in, size_t n, std::string& out) {
+    size_t code_pos = out.size();
+    out.push_back('\0');
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < n; ++i) {
+        if (in[i] != 0) {
+            out.push_back(static_cast<char>(in[i]));
+            ++code;
+        }
+        if (in[i] == 0 || code == 0xFF) {
+            out[code_pos] = static_cast<char>(code);
+            code_pos = out.size();
+            out.push_back('\0');
+            code = 1;
+        }
+    }
+
+    out[code_pos] = static_cast<char>(code);
+    out.push_back('\0');
+}
+
+static size_t bytes_per_sample(uint8_t enc) {
+    switch (static_cast<BinaryEncoding>(enc)) {
+    case BinaryEncoding::Int16: return 2;
+    case BinaryEncoding::Int24: return 3;
+    case BinaryEncoding::Float32: return 4;
+    }
+    return 0;
+}
+
+// Validates a decoded packet; returns its channel count or 0.
+static size_t check_packet(const std::vector<uint8_t>& raw) {
+    if (raw.size() < BinaryFrameDecoder::kHeaderBytes + 2) return 0;
+    if (raw[0] != BinaryFrameDecoder::kMagic) return 0;
+
+    size_t bps = bytes_per_sample(raw[1]);
+    size_t n = raw[2];
+    if (bps == 0 || n == 0) return 0;
+    if (raw.size() != BinaryFrameDecoder::kHeaderBytes + n * bps + 2) return 0;
+
+    size_t body = raw.size() - 2;
+    uint16_t want = static_cast<uint16_t>(raw[body] | (raw[body + 1] << 8));
+    if (BinaryFrameDecoder::crc16(raw.data(), body) != want) return 0;
+
+    return n;
+}
+
+void BinaryFrameDecoder::clear() {
+    cobs_.clear();
+    raw_.clear();
+    synced_ = false;
+    overflow_ = false;
+    has_seq_ = false;
+    last_seq_ = 0;
+    lost_ = 0;
+}
+
+bool BinaryFrameDecoder::decode_packet(uint64_t t_ns, FrameBlock& blk) {
+    if (!cobs_decode(cobs_.data(), cobs_.size(), raw_)) return false;
+
+    size_t n = check_packet(raw_);
+    if (n == 0) return false;
+
+    if (blk.n_ch == 0) {
+        blk.n_ch = n;
+        blk.n_frames = 0;
+    } else if (blk.n_ch != n) {
+        return false;
+    }
+
+    uint16_t seq = static_cast<uint16_t>(raw_[3] | (raw_[4] << 8));
+    if (has_seq_) {
+        uint16_t d = static_cast<uint16_t>(seq - last_seq_);
+        if (d > 1 && d < 0x8000) lost_ += (uint64_t)(d - 1);
+    }
+    has_seq_ = true;
+    last_seq_ = seq;
+
+    const uint8_t* s = raw_.data() + kHeaderBytes;
+    float* x = blk.append(t_ns);
+    blk.seq[blk.n_frames - 1] = seq;
+
+    switch (static_cast<BinaryEncoding>(raw_[1])) {
+    case BinaryEncoding::Int16:
+        for (size_t i = 0; i < n; ++i, s += 2) {
+            x[i] = static_cast<float>(static_cast<int16_t>(s[0] | (s[1] << 8)));
+        }
+        break;
+    case BinaryEncoding::Int24:
+        for (size_t i = 0; i < n; ++i, s += 3) {
+            int32_t v = (int32_t)s[0] | ((int32_t)s[1] << 8) | ((int32_t)s[2] << 16);
+            if (v & 0x800000) v -= 0x1000000;
+            x[i] = static_cast<float>(v);
+        }
+        break;
+    case BinaryEncoding::Float32:
+        for (size_t i = 0; i < n; ++i, s += 4) {
+            uint32_t u = (uint32_t)s[0] | ((uint32_t)s[1] << 8) | ((uint32_t)s[2] << 16) | ((uint32_t)s[3] << 24);
+            std::memcpy(&x[i], &u, 4);
+        }
+        break;
+    }
+    return true;
+}
+
+size_t BinaryFrameDecoder::decode_block(std::string_view chunk, uint64_t t_ns, FrameBlock& blk) {
+    // COBS never emits 0x00 inside a packet, so packets can span chunks freely.
+    const size_t max_cobs = kMaxPacketBytes + kMaxPacketBytes / 254 + 1;
+
+    blk.has_seq = true;
+    blk.seq_bits = 16;
+
+    size_t bad = 0;
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(chunk.data());
+    const uint8_t* e = p + chunk.size();
+
+    while (p < e) {
+        const uint8_t* z = static_cast<const uint8_t*>(std::memchr(p, 0, (size_t)(e - p)));
+        const uint8_t* end = z ? z : e;
+
+        // Before the first delimiter we may be in the middle of a packet: drop it.
+        if (synced_ && !overflow_) {
+            size_t add = (size_t)(end - p);
+            if (cobs_.size() + add > max_cobs) overflow_ = true;
+            else cobs_.insert(cobs_.end(), p, end);
+        }
+
+        if (!z) break;
+
+        if (synced_) {
+            if (overflow_) ++bad;
+            else if (!cobs_.empty() && !decode_packet(t_ns, blk)) ++bad;
+        }
+
+        cobs_.clear();
+        overflow_ = false;
+        synced_ = true;
+        p = z + 1;
+    }
+
+    return bad;
+}
+
+void BinaryFrameDecoder::encode_frame(uint16_t seq, BinaryEncoding enc, const float* x, size_t n, std::string& out) {
+    if (n == 0 || n > 255) return;
+
+    size_t bps = bytes_per_sample(static_cast<uint8_t>(enc));
+    if (bps == 0) return;
+
+    uint8_t raw[kMaxPacketBytes];
+    size_t k = 0;
+    raw[k++] = kMagic;
+    raw[k++] = static_cast<uint8_t>(enc);
+    raw[k++] = static_cast<uint8_t>(n);
+    raw[k++] = static_cast<uint8_t>(seq & 0xFF);
+    raw[k++] = static_cast<uint8_t>(seq >> 8);
+
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t u = 0;
+        if (enc == BinaryEncoding::Float32) {
+            std::memcpy(&u, &x[i], 4);
+        } else {
+            double lim = (enc == BinaryEncoding::Int16) ? 32767.0 : 8388607.0;
+            double v = (double)x[i];
+            if (v > lim) v = lim;
+            if (v < -lim - 1.0) v = -lim - 1.0;
+            u = static_cast<uint32_t>(static_cast<int32_t>(v < 0 ? v - 0.5 : v + 0.5));
+        }
+        for (size_t b = 0; b < bps; ++b) raw[k++] = static_cast<uint8_t>((u >> (8 * b)) & 0xFF);
+    }
+
+    uint16_t crc = crc16(raw, k);
+    raw[k++] = static_cast<uint8_t>(crc & 0xFF);
+    raw[k++] = static_cast<uint8_t>(crc >> 8);
+
+    cobs_encode(raw, k, out);
+}
+
+WireFormat detect_wire_format(std::string_view head) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(head.data());
+    const size_t n = head.size();
+
+    std::vector<uint8_t> raw;
+    bool printable = true;
+    bool has_eol = false;
+    size_t start = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        uint8_t c = p[i];
+        if (c == 0) {
+            printable = false;
+            if (i > start && cobs_decode(p + start, i - start, raw) && check_packet(raw) != 0) {
+                return WireFormat::Binary;
+            }
+            start = i + 1;
+        } else if (c == '\n' || c == '\r') {
+            has_eol = true;
+        } else if (c != '\t' && (c < 0x20 || c >= 0x7F)) {
+            printable = false;
+        }
+    }
+
+    if (printable && has_eol) return WireFormat::Csv;
+    return WireFormat::Unknown;
+}
+
+}
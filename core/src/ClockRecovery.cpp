@@ -0,0 +1,122 @@
+#include "hub/ClockRecovery.h"
+#include <cmath>
+
+namespace hub {
+
+// Observations before the fitted period is trusted.
+static constexpr size_t kLockObservations = 16;
+
+// A burst this far (seconds) from the prediction means the stream stalled or
+// restarted; the fit starts over.
+static constexpr double kResyncError = 0.5;
+
+void ClockRecovery::reset() {
+    has_seq_ = false;
+    last_seq_ = 0;
+    k_ = 0.0;
+
+    t0_ns_ = 0;
+    prev_arrival_ns_ = 0;
+    last_out_ns_ = 0;
+
+    n_obs_ = 0;
+    mk_ = mt_ = 0.0;
+    ckk_ = ckt_ = 0.0;
+
+    locked_ = false;
+    period_s_ = 0.0;
+}
+
+void ClockRecovery::observe(double k, double t_s) {
+    if (n_obs_ == 0) {
+        mk_ = k;
+        mt_ = t_s;
+        ckk_ = ckt_ = 0.0;
+        n_obs_ = 1;
+        return;
+    }
+
+    // Weight of the new point: 1/n while warming up, then 1 - forget.
+    double w = 1.0 / (double)(n_obs_ + 1);
+    if (w < 1.0 - forget_) w = 1.0 - forget_;
+
+    double dk = k - mk_;
+    double dt = t_s - mt_;
+    mk_ += w * dk;
+    mt_ += w * dt;
+    ckk_ = (1.0 - w) * (ckk_ + w * dk * dk);
+    ckt_ = (1.0 - w) * (ckt_ + w * dk * dt);
+    ++n_obs_;
+
+    if (ckk_ > 0.0) {
+        double p = ckt_ / ckk_;
+        if (p > 0.0) period_s_ = p;
+    }
+    if (n_obs_ >= kLockObservations && period_s_ > 0.0) locked_ = true;
+}
+
+void ClockRecovery::apply(FrameBlock& blk) {
+    const size_t nf = blk.n_frames;
+    if (nf == 0) return;
+
+    const uint64_t arrival = blk.t_ns[nf - 1];
+    if (t0_ns_ == 0) t0_ns_ = arrival;
+
+    // Sample index of every frame in the burst.
+    const uint64_t mask = (blk.seq_bits > 0 && blk.seq_bits < 64) ? ((1ull << blk.seq_bits) - 1) : ~0ull;
+    if (idx_.size() < nf) idx_.resize(nf);
+    for (size_t i = 0; i < nf; ++i) {
+        double step = 1.0;
+        if (blk.has_seq) {
+            uint64_t s = blk.seq[i] & mask;
+            if (has_seq_) {
+                // Forward gaps keep their slots; restarts/duplicates count as one.
+                uint64_t d = (s - last_seq_) & mask;
+                if (d >= 1 && d <= (mask >> 1)) step = (double)d;
+            }
+            has_seq_ = true;
+            last_seq_ = s;
+        }
+        k_ += step;
+        idx_[i] = k_;
+    }
+
+    const double t_arr = (double)(arrival - t0_ns_) * 1e-9;
+
+    if (locked_) {
+        double pred = mt_ + period_s_ * (k_ - mk_);
+        if (std::fabs(t_arr - pred) > kResyncError) {
+            n_obs_ = 0;
+            locked_ = false;
+        }
+    }
+
+    observe(k_, t_arr);
+
+    uint64_t min_step = 1;
+    if (locked_) {
+        for (size_t i = 0; i < nf; ++i) {
+            double t_s = mt_ + period_s_ * (idx_[i] - mk_);
+            blk.t_ns[i] = t0_ns_ + (uint64_t)std::llround(t_s > 0.0 ? t_s * 1e9 : 0.0);
+        }
+        min_step = (uint64_t)(period_s_ * 0.5e9) + 1;
+    } else {
+        // Not locked yet: spread the burst over the interval since the previous one.
+        uint64_t start = prev_arrival_ns_ ? prev_arrival_ns_ : arrival;
+        if (start > arrival) start = arrival;
+        double span = (double)(arrival - start);
+        for (size_t i = 0; i < nf; ++i) {
+            blk.t_ns[i] = start + (uint64_t)std::llround(span * (double)(i + 1) / (double)nf);
+        }
+    }
+
+    // Keep time increasing across bursts when the fit moves back a little.
+    for (size_t i = 0; i < nf; ++i) {
+        if (last_out_ns_ != 0 && blk.t_ns[i] < last_out_ns_ + min_step) blk.t_ns[i] = last_out_ns_ + min_step;
+        last_out_ns_ = blk.t_ns[i];
+    }
+
+    prev_arrival_ns_ = arrival;
+}
+
+}
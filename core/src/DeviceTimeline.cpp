@@ -0,0 +1,112 @@
+#include "hub/DeviceTimeline.h"
+#include <cmath>
+
+namespace hub {
+
+void DeviceTimeline::reset() {
+    has_seq_ = false;
+    last_seq_ = 0;
+
+    has_t_ = false;
+    last_raw_t_ = 0.0;
+    t_wrap_base_ = 0.0;
+    t_anchor_ticks_ = 0.0;
+    t_anchor_ns_ = 0;
+    last_t_s_ = 0.0;
+    period_s_ = 0.0;
+
+    lost_ = 0;
+    gaps_ = 0;
+    resets_ = 0;
+}
+
+uint64_t DeviceTimeline::track_seq(uint64_t raw, unsigned bits) {
+    const uint64_t mask = (bits > 0 && bits < 64) ? ((1ull << bits) - 1) : ~0ull;
+    raw &= mask;
+
+    if (!has_seq_) {
+        has_seq_ = true;
+        last_seq_ = raw;
+        return 0;
+    }
+
+    // Modular step; anything in the upper half of the range ran backwards.
+    uint64_t d = (raw - last_seq_) & mask;
+    uint64_t half = (mask >> 1) + 1;
+
+    last_seq_ = raw;
+
+    if (d == 0 || d >= half) {
+        ++resets_;
+        return 0;
+    }
+    if (d > 1) {
+        ++gaps_;
+        lost_ += d - 1;
+    }
+    return d;
+}
+
+uint64_t DeviceTimeline::map_time(double raw, unsigned bits, double unit_s, uint64_t host_ns, uint64_t steps) {
+    const double wrap = (bits > 0 && bits < 64) ? std::ldexp(1.0, (int)bits) : 0.0;
+
+    if (has_t_ && wrap > 0.0 && raw < last_raw_t_ - wrap * 0.5) t_wrap_base_ += wrap;
+
+    double t_s = (t_wrap_base_ + raw - t_anchor_ticks_) * unit_s;
+
+    if (!has_t_ || t_s < last_t_s_) {
+        // First sample, or the device clock restarted: anchor to the host.
+        if (has_t_) ++resets_;
+        has_t_ = true;
+        t_wrap_base_ = 0.0;
+        t_anchor_ticks_ = raw;
+        t_anchor_ns_ = host_ns;
+        last_raw_t_ = raw;
+        last_t_s_ = 0.0;
+        return host_ns;
+    }
+
+    double dt = t_s - last_t_s_;
+    if (dt > 0.0) {
+        if (period_s_ <= 0.0) {
+            if (steps <= 1) period_s_ = dt;
+        } else {
+            // Sample periods covered by dt: from the counter when there is one,
+            // else inferred from the time step (and counted as lost).
+            double k = (double)steps;
+            if (steps == 0) {
+                k = 1.0;
+                if (dt > 1.5 * period_s_) {
+                    k = std::floor(dt / period_s_ + 0.5);
+                    ++gaps_;
+                    lost_ += (uint64_t)(k - 1.0);
+                }
+            }
+            // Clamped so a single odd step barely moves the estimate.
+            double step = dt / k;
+            if (step > 2.0 * period_s_) step = 2.0 * period_s_;
+            period_s_ += 0.02 * (step - period_s_);
+        }
+    }
+
+    last_raw_t_ = raw;
+    last_t_s_ = t_s;
+    return t_anchor_ns_ + (uint64_t)std::llround(t_s * 1e9);
+}
+
+void DeviceTimeline::apply(FrameBlock& blk) {
+    for (size_t i = 0; i < blk.n_frames; ++i) {
+        // Without a counter, steps = 0 lets map_time infer gaps from time.
+        // A counter restart gives 1 so the time step is not counted as lost.
+        uint64_t steps = 0;
+        if (blk.has_seq) {
+            steps = track_seq(blk.seq[i], blk.seq_bits);
+            if (steps == 0) steps = 1;
+        }
+        if (blk.has_dev_t) {
+            blk.t_ns[i] = map_time(blk.dev_t[i], blk.dev_t_bits, blk.dev_t_unit_s, blk.t_ns[i], steps);
+        }
+    }
+}
+
+}
@@ -0,0 +1,117 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <utility>
+#include "hub/Fft.h"
+
+namespace hub {
+
+size_t Fft::next_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+void Fft::resize(size_t n) {
+    if (!is_pow2(n)) n = next_pow2(n);
+    if (n == n_) return;
+    n_ = n;
+
+    tw_.resize(n_ / 2);
+    for (size_t k = 0; k < tw_.size(); ++k) {
+        const double a = -2.0 * M_PI * (double)k / (double)n_;
+        tw_[k] = std::complex<double>(std::cos(a), std::sin(a));
+    }
+
+    size_t bits = 0;
+    while (((size_t)1 << bits) < n_) ++bits;
+    rev_.resize(n_);
+    for (size_t i = 0; i < n_; ++i) {
+        size_t r = 0;
+        for (size_t b = 0; b < bits; ++b) r |= ((i >> b) & 1) << (bits - 1 - b);
+        rev_[i] = r;
+    }
+}
+
+void Fft::forward(std::complex<double>* x) const {
+    run(x, false);
+}
+
+void Fft::inverse(std::complex<double>* x) const {
+    run(x, true);
+    const double s = 1.0 / (double)n_;
+    for (size_t i = 0; i < n_; ++i) x[i] *= s;
+}
+
+void Fft::run(std::complex<double>* x, bool inv) const {
+    for (size_t i = 0; i < n_; ++i) {
+        if (i < rev_[i]) std::swap(x[i], x[rev_[i]]);
+    }
+
+    for (size_t len = 2; len <= n_; len <<= 1) {
+        const size_t half = len / 2;
+        const size_t step = n_ / len;
+        for (size_t i = 0; i < n_; i += len) {
+            for (size_t k = 0; k < half; ++k) {
+                std::complex<double> w = tw_[k * step];
+                if (inv) w = std::conj(w);
+                // Written out: operator* on std::complex carries inf/nan checks.
+                const std::complex<double> a = x[i + k];
+                const std::complex<double> b = x[i + k + half];
+                const double br = b.real() * w.real() - b.imag() * w.imag();
+                const double bi = b.real() * w.imag() + b.imag() * w.real();
+                x[i + k] = std::complex<double>(a.real() + br, a.imag() + bi);
+                x[i + k + half] = std::complex<double>(a.real() - br, a.imag() - bi);
+            }
+        }
+    }
+}
+
+void RealFft::resize(size_t n) {
+    if (n < 2) n = 2;
+    if (!Fft::is_pow2(n)) n = Fft::next_pow2(n);
+    if (n == n_) return;
+    n_ = n;
+    half_.resize(n_ / 2);
+
+    tw_.resize(n_ / 4 + 1);
+    for (size_t k = 0; k < tw_.size(); ++k) {
+        const double a = -2.0 * M_PI * (double)k / (double)n_;
+        tw_[k] = std::complex<double>(std::cos(a), std::sin(a));
+    }
+}
+
+void RealFft::forward(const double* x, std::complex<double>* X) const {
+    const size_t m = n_ / 2;
+    for (size_t i = 0; i < m; ++i) X[i] = std::complex<double>(x[2 * i], x[2 * i + 1]);
+    half_.forward(X);
+
+    // Z = E + iO with E, O the transforms of the even and odd samples:
+    // X[k] = E[k] + w^k O[k]. Bins k and m - k come from the same pair of
+    // Z values, so they are rewritten together.
+    const double z0r = X[0].real();
+    const double z0i = X[0].imag();
+    X[0] = std::complex<double>(z0r + z0i, 0.0);
+    X[m] = std::complex<double>(z0r - z0i, 0.0);
+
+    for (size_t k = 1; 2 * k <= m; ++k) {
+        const size_t j = m - k;
+        const std::complex<double> zk = X[k];
+        const std::complex<double> zj = X[j];
+
+        // E[k] = (Z[k] + conj Z[j]) / 2, O[k] = (Z[k] - conj Z[j]) / 2i.
+        const double er = 0.5 * (zk.real() + zj.real());
+        const double ei = 0.5 * (zk.imag() - zj.imag());
+        const double or_ = 0.5 * (zk.imag() + zj.imag());
+        const double oi = -0.5 * (zk.real() - zj.real());
+
+        // w^j = -conj(w^k); E[j] = conj E[k], O[j] = conj O[k].
+        const double wr = tw_[k].real();
+        const double wi = tw_[k].imag();
+        const double tr = or_ * wr - oi * wi;
+        const double ti = or_ * wi + oi * wr;
+        X[k] = std::complex<double>(er + tr, ei + ti);
+        X[j] = std::complex<double>(er - tr, -ei + ti);
+    }
+}
+
+}
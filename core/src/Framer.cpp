@@ -3,36 +3,82 @@
 namespace hub {
 
 std::vector<std::string> LineFramer::push(std::string_view chunk) {
-    buf_.append(chunk.data(), chunk.size());
-
     std::vector<std::string> out;
-    size_t start = 0;
+
+    feed(chunk);
+    std::string_view line;
+    while (next(line)) out.emplace_back(line);
+
+    return out;
+}
+
+void LineFramer::feed(std::string_view chunk) {
+    // Anything left in the previous chunk was already stashed by next().
+    if (drop_buf_) {
+        buf_.clear();
+        drop_buf_ = false;
+    }
+    cur_ = chunk;
+    pos_ = 0;
+}
+
+bool LineFramer::next(std::string_view& line) {
+    if (drop_buf_) {
+        buf_.clear();
+        drop_buf_ = false;
+    }
+
+    const size_t n = cur_.size();
+
+    // "\r\n" split across two chunks: the '\r' already terminated the line.
+    if (pending_cr_ && pos_ < n) {
+        if (cur_[pos_] == '\n') ++pos_;
+        pending_cr_ = false;
+    }
+
+    if (pos_ >= n) return false;
+
+    const char* data = cur_.data();
+    size_t nl = pos_;
 
     // Accept any of: "\n", "\r", "\r\n" as line terminators.
     // This makes Serial streams robust: some devices emit CR-only.
-    for (;;) {
-        size_t nl = buf_.find_first_of("\r\n", start);
-        if (nl == std::string::npos) break;
+    while (nl < n && data[nl] != '\n' && data[nl] != '\r') ++nl;
 
-        size_t end = nl;
+    if (nl == n) {
+        // Partial line: keep it for the next chunk so the caller's buffer can go away.
+        buf_.append(data + pos_, n - pos_);
+        pos_ = n;
+        return false;
+    }
 
-        if (end > start) out.emplace_back(buf_.substr(start, end - start));
-        else out.emplace_back(std::string());
+    if (buf_.empty()) {
+        line = std::string_view(data + pos_, nl - pos_);
+    } else {
+        buf_.append(data + pos_, nl - pos_);
+        line = std::string_view(buf_);
+        drop_buf_ = true;
+    }
 
-        // Consume delimiter (\r\n treated as a single newline)
-        size_t adv = 1;
-        if (buf_[nl] == '\r' && (nl + 1) < buf_.size() && buf_[nl + 1] == '\n') {
-            adv = 2;
+    // Consume delimiter (\r\n treated as a single newline)
+    size_t adv = 1;
+    if (data[nl] == '\r') {
+        if (nl + 1 < n) {
+            if (data[nl + 1] == '\n') adv = 2;
+        } else {
+            pending_cr_ = true;
         }
-        start = nl + adv;
     }
-
-    if (start > 0) buf_.erase(0, start);
-    return out;
+    pos_ = nl + adv;
+    return true;
 }
 
 void LineFramer::clear() {
     buf_.clear();
+    cur_ = std::string_view();
+    pos_ = 0;
+    drop_buf_ = false;
+    pending_cr_ = false;
 }
 
 }
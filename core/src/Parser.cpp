@@ -1,5 +1,9 @@
 #include "hub/Parser.h"
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <string>
 
 namespace hub {
 
@@ -11,6 +15,138 @@ static inline bool is_number_start(char c) {
     return (c >= '0' && c <= '9') || c == '+' || c == '-' || c == '.';
 }
 
+static inline bool is_separator(char c) {
+    return c == ',' || c == ';' || c == '|' || c == ' ' || c == '\t';
+}
+
+static inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// SWAR digit classification/conversion on 8 bytes (little-endian load).
+static inline bool is_eight_digits(uint64_t v) {
+    return (((v & 0xF0F0F0F0F0F0F0F0ull) |
+             (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull);
+}
+
+static inline uint32_t parse_eight_digits(uint64_t v) {
+    const uint64_t mask = 0x000000FF000000FFull;
+    const uint64_t mul1 = 0x000F424000000064ull; // 100 + (1000000 << 32)
+    const uint64_t mul2 = 0x0000271000000001ull; // 1 + (10000 << 32)
+    v -= 0x3030303030303030ull;
+    v = (v * 10) + (v >> 8);
+    v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+    return static_cast<uint32_t>(v);
+}
+
+static inline const char* scan_digits(const char* p, const char* e, uint64_t& m, int& nd) {
+    while (e - p >= 8) {
+        uint64_t w;
+        std::memcpy(&w, p, 8);
+        if (!is_eight_digits(w)) break;
+        m = m * 100000000ull + parse_eight_digits(w);
+        nd += 8;
+        p += 8;
+    }
+    while (p < e && is_digit(*p)) {
+        m = m * 10 + static_cast<uint64_t>(*p - '0');
+        ++nd;
+        ++p;
+    }
+    return p;
+}
+
+// Decimal fast path (Clinger): when the mantissa fits in 24 bits and the power
+// of ten is exact in float, one IEEE multiply/divide is correctly rounded and
+// therefore equal to strtof(). Returns nullptr when the token needs strtof().
+static const char* decode_fast(const char* p, const char* e, float& out) {
+    static const float kPow10[] = {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+
+    bool neg = false;
+    if (p < e && (*p == '+' || *p == '-')) {
+        neg = (*p == '-');
+        ++p;
+    }
+
+    uint64_t m = 0;
+    int nd = 0;
+    p = scan_digits(p, e, m, nd);
+    int nint = nd;
+
+    int exp10 = 0;
+    if (p < e && *p == '.') {
+        ++p;
+        p = scan_digits(p, e, m, nd);
+        exp10 = -(nd - nint);
+    }
+
+    if (nd == 0) return nullptr;   // ".", "-", "inf", "nan", ...
+    if (nd > 19) return nullptr;   // mantissa may have overflowed
+
+    if (p < e && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool eneg = false;
+        if (q < e && (*q == '+' || *q == '-')) {
+            eneg = (*q == '-');
+            ++q;
+        }
+        if (q < e && is_digit(*q)) {
+            int ev = 0;
+            while (q < e && is_digit(*q)) {
+                if (ev < 10000) ev = ev * 10 + (*q - '0');
+                ++q;
+            }
+            exp10 += eneg ? -ev : ev;
+            p = q;
+        }
+        // else: strtof() stops before a dangling exponent marker, and so do we.
+    }
+
+    // strtof() would continue into a hex literal ("0x1F").
+    if (p < e && (*p == 'x' || *p == 'X')) return nullptr;
+
+    float v;
+    if (m == 0) {
+        v = 0.0f;
+    } else {
+        if (m > (1ull << 24)) return nullptr;
+        if (exp10 < -10 || exp10 > 10) return nullptr;
+        v = static_cast<float>(m);
+        if (exp10 < 0) v /= kPow10[-exp10];
+        else v *= kPow10[exp10];
+    }
+
+    out = neg ? -v : v;
+    return p;
+}
+
+// Exact fallback: strtof() on a NUL-terminated copy of the token.
+static const char* decode_slow(const char* p, const char* e, float& out) {
+    const char* t = p;
+    while (t < e && !is_separator(*t)) ++t;
+    size_t len = static_cast<size_t>(t - p);
+
+    char small[64];
+    std::string big;
+    const char* s = small;
+    if (len < sizeof(small)) {
+        std::memcpy(small, p, len);
+        small[len] = '\0';
+    } else {
+        big.assign(p, len);
+        s = big.c_str();
+    }
+
+    char* endp = nullptr;
+    float v = std::strtof(s, &endp);
+    if (endp == s) return nullptr;
+
+    out = v;
+    return p + (endp - s);
+}
+
 std::optional<std::vector<float>> CsvFloatParser::parse_line(std::string_view line) const {
     const char* p = line.data();
     const char* e = p + line.size();
@@ -63,4 +199,189 @@ std::optional<std::vector<float>> CsvFloatParser::parse_line(std::string_view li
     return vals;
 }
 
+// Walks the values of a line with the parse_line() grammar. `decode(p, e, i)`
+// decodes value i starting at p and returns the end of the number, or nullptr.
+// Returns the number of values, or 0 if the line is malformed or decode failed.
+template <class Decode>
+static size_t scan_values(std::string_view line, Decode&& decode) {
+    const char* p = line.data();
+    const char* e = p + line.size();
+
+    size_t n = 0;
+
+    for (;;) {
+        for (;;) {
+            skip_ws(p, e);
+            if (p >= e) break;
+            if (*p == ',' || *p == ';' || *p == '|') {
+                ++p;
+                continue;
+            }
+            break;
+        }
+        if (p >= e) break;
+
+        const char* endp = decode(p, e, n);
+        if (!endp) return 0;
+
+        ++n;
+        p = endp;
+
+        skip_ws(p, e);
+        if (p >= e) break;
+
+        if (*p == ',' || *p == ';' || *p == '|') {
+            ++p;
+            continue;
+        }
+
+        if (is_number_start(*p)) {
+            continue;
+        }
+
+        return 0;
+    }
+
+    return n;
+}
+
+// strtod() on a NUL-terminated copy of the token; used for device columns,
+// where float would lose counts above 2^24.
+static const char* decode_double(const char* p, const char* e, double& out) {
+    const char* t = p;
+    while (t < e && !is_separator(*t)) ++t;
+    size_t len = static_cast<size_t>(t - p);
+
+    char small[64];
+    std::string big;
+    const char* s = small;
+    if (len < sizeof(small)) {
+        std::memcpy(small, p, len);
+        small[len] = '\0';
+    } else {
+        big.assign(p, len);
+        s = big.c_str();
+    }
+
+    char* endp = nullptr;
+    double v = std::strtod(s, &endp);
+    if (endp == s) return nullptr;
+
+    out = v;
+    return p + (endp - s);
+}
+
+size_t CsvFloatParser::parse_into(std::string_view line, float* out, size_t cap) const {
+    // Same grammar as parse_line(); only the number decoder differs.
+    return scan_values(line, [out, cap](const char* p, const char* e, size_t i) -> const char* {
+        if (i >= cap) return nullptr;
+        float v = 0.0f;
+        const char* endp = decode_fast(p, e, v);
+        if (!endp) endp = decode_slow(p, e, v);
+        if (endp) out[i] = v;
+        return endp;
+    });
+}
+
+size_t CsvFloatParser::parse_block(LineFramer& framer, uint64_t t_ns, FrameBlock& blk) const {
+    if (layout_.has_device_columns()) return parse_block_with_columns(framer, t_ns, blk);
+
+    size_t bad = 0;
+    std::string_view line;
+
+    while (framer.next(line)) {
+        if (blk.n_ch == 0) {
+            float tmp[kMaxValues];
+            size_t n = parse_into(line, tmp, kMaxValues);
+            if (n == 0) {
+                // Malformed, or wider than the scratch buffer.
+                auto wide = parse_line(line);
+                if (!wide) { ++bad; continue; }
+                blk.n_ch = wide->size();
+                blk.n_frames = 0;
+                std::memcpy(blk.append(t_ns), wide->data(), blk.n_ch * sizeof(float));
+                continue;
+            }
+
+            blk.n_ch = n;
+            blk.n_frames = 0;
+            std::memcpy(blk.append(t_ns), tmp, n * sizeof(float));
+            continue;
+        }
+
+        // Parse straight into the next row; a line with more values than n_ch
+        // makes parse_into() fail, one with fewer is caught by the count check.
+        float* r = blk.append(t_ns);
+        size_t n = parse_into(line, r, blk.n_ch);
+        if (n != blk.n_ch) {
+            blk.pop_back();
+            ++bad;
+        }
+    }
+
+    return bad;
+}
+
+size_t CsvFloatParser::parse_block_with_columns(LineFramer& framer, uint64_t t_ns, FrameBlock& blk) const {
+    const int sc = layout_.seq_col;
+    const int tc = layout_.time_col;
+    const size_t n_meta = (sc >= 0 ? 1 : 0) + (tc >= 0 && tc != sc ? 1 : 0);
+
+    blk.has_seq = (sc >= 0);
+    blk.seq_bits = layout_.seq_bits;
+    blk.has_dev_t = (tc >= 0);
+    blk.dev_t_bits = layout_.time_bits;
+    blk.dev_t_unit_s = layout_.time_unit_s;
+
+    size_t bad = 0;
+    std::string_view line;
+    float vals[kMaxValues];
+    std::vector<float> spill;   // values past kMaxValues; only wide lines allocate
+
+    while (framer.next(line)) {
+        double seq = 0.0;
+        double dev_t = 0.0;
+        size_t nd = 0;
+        spill.clear();
+
+        size_t n = scan_values(line, [&](const char* p, const char* e, size_t i) -> const char* {
+            if ((int)i == sc || (int)i == tc) {
+                double v = 0.0;
+                const char* endp = decode_double(p, e, v);
+                if ((int)i == sc) seq = v;
+                if ((int)i == tc) dev_t = v;
+                return endp;
+            }
+            float v = 0.0f;
+            const char* endp = decode_fast(p, e, v);
+            if (!endp) endp = decode_slow(p, e, v);
+            if (!endp) return nullptr;
+            if (nd < kMaxValues) vals[nd] = v;
+            else spill.push_back(v);
+            ++nd;
+            return endp;
+        });
+
+        // Every device column must be present, plus at least one channel.
+        if (n == 0 || n != nd + n_meta || nd == 0 || seq < 0.0) { ++bad; continue; }
+
+        if (blk.n_ch == 0) {
+            blk.n_ch = nd;
+            blk.n_frames = 0;
+        } else if (nd != blk.n_ch) {
+            ++bad;
+            continue;
+        }
+
+        float* r = blk.append(t_ns);
+        std::memcpy(r, vals, std::min(nd, kMaxValues) * sizeof(float));
+        if (!spill.empty()) std::memcpy(r + kMaxValues, spill.data(), spill.size() * sizeof(float));
+        size_t k = blk.n_frames - 1;
+        if (blk.has_seq) blk.seq[k] = static_cast<uint64_t>(seq);
+        if (blk.has_dev_t) blk.dev_t[k] = dev_t;
+    }
+
+    return bad;
+}
+
 }
@@ -1,28 +1,536 @@
 #include "hub/Pipeline.h"
+#include <array>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HUB_PIPELINE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define HUB_TARGET_SSE2
+#define HUB_TARGET_AVX2
+#else
+#define HUB_TARGET_SSE2 __attribute__((target("sse2")))
+#define HUB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
 
 namespace hub {
 
-void Pipeline::reset() {
-    n_ch_ = 0;
+// ---- Stage kernels -----------------------------------------------------------
+//
+// An op filters one channel (scalar) or the four channels starting at c (sse2,
+// avx2) of the current frame and updates its state. run_row() applies a list
+// of ops to a whole frame, chunk by chunk, so a chain of ops is one pass over
+// the frame with the samples kept in registers between stages. Every version
+// performs the same IEEE operations in the same order as the scalar code (no
+// FMA), so all levels give identical output.
+
+struct MaOp {
+    float* slot;    // ring row being replaced
+    double* sum;
+    double win;
+
+    float scalar(float v, size_t c) const {
+        float oldv = slot[c];
+        slot[c] = v;
+        sum[c] += (double)v - (double)oldv;
+        return (float)(sum[c] / win);
+    }
+#ifdef HUB_PIPELINE_X86
+    HUB_TARGET_SSE2 __m128 sse2(__m128 v, size_t c) const {
+        const __m128d w = _mm_set1_pd(win);
+        __m128 of = _mm_loadu_ps(slot + c);
+        _mm_storeu_ps(slot + c, v);
+
+        __m128d lo = _mm_add_pd(_mm_loadu_pd(sum + c),
+                                _mm_sub_pd(_mm_cvtps_pd(v), _mm_cvtps_pd(of)));
+        __m128d hi = _mm_add_pd(_mm_loadu_pd(sum + c + 2),
+                                _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(v, v)), _mm_cvtps_pd(_mm_movehl_ps(of, of))));
+        _mm_storeu_pd(sum + c, lo);
+        _mm_storeu_pd(sum + c + 2, hi);
+
+        return _mm_movelh_ps(_mm_cvtpd_ps(_mm_div_pd(lo, w)), _mm_cvtpd_ps(_mm_div_pd(hi, w)));
+    }
+    HUB_TARGET_AVX2 __m128 avx2(__m128 v, size_t c) const {
+        __m128 of = _mm_loadu_ps(slot + c);
+        _mm_storeu_ps(slot + c, v);
+
+        __m256d sm = _mm256_add_pd(_mm256_loadu_pd(sum + c),
+                                   _mm256_sub_pd(_mm256_cvtps_pd(v), _mm256_cvtps_pd(of)));
+        _mm256_storeu_pd(sum + c, sm);
+        return _mm256_cvtpd_ps(_mm256_div_pd(sm, _mm256_set1_pd(win)));
+    }
+#endif
+};
 
-    ma_inited_ = false;
-    ma_pos_ = 0;
-    ma_ring_.clear();
-    ma_sum_.clear();
+struct EmaOp {
+    float* y;
+    float a;
 
-    ema_inited_ = false;
-    ema_state_.clear();
+    float scalar(float v, size_t c) const {
+        y[c] = a * v + (1.0f - a) * y[c];
+        return y[c];
+    }
+#ifdef HUB_PIPELINE_X86
+    HUB_TARGET_SSE2 __m128 sse2(__m128 v, size_t c) const {
+        __m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a), v), _mm_mul_ps(_mm_set1_ps(1.0f - a), _mm_loadu_ps(y + c)));
+        _mm_storeu_ps(y + c, r);
+        return r;
+    }
+    HUB_TARGET_AVX2 __m128 avx2(__m128 v, size_t c) const { return sse2(v, c); }
+#endif
+};
+
+// Cascade of biquads. Transposed direct form II, except a single notch, which
+// runs in direct form I as it always has. The signal stays in double between
+// sections.
+struct SosOp {
+    const Biquad* sec;
+    size_t n_sec;
+    double* z;      // per section: z1, z2 [n] (tdf2) or x1, x2, y1, y2 [n] (df1)
+    size_t n;
+    bool df1;
+
+    float scalar(float v, size_t c) const {
+        double x = (double)v;
+        for (size_t s = 0; s < n_sec; ++s) {
+            const Biquad& q = sec[s];
+            if (df1) {
+                double* x1 = z + 4 * s * n;
+                double* x2 = x1 + n;
+                double* y1 = x2 + n;
+                double* y2 = y1 + n;
+                double y = q.b0 * x + q.b1 * x1[c] + q.b2 * x2[c] - q.a1 * y1[c] - q.a2 * y2[c];
+                x2[c] = x1[c];
+                x1[c] = x;
+                y2[c] = y1[c];
+                y1[c] = y;
+                x = y;
+                continue;
+            }
+            double* z1 = z + 2 * s * n;
+            double* z2 = z1 + n;
+            double y = q.b0 * x + z1[c];
+            z1[c] = q.b1 * x - q.a1 * y + z2[c];
+            z2[c] = q.b2 * x - q.a2 * y;
+            x = y;
+        }
+        return (float)x;
+    }
+#ifdef HUB_PIPELINE_X86
+    HUB_TARGET_SSE2 __m128d step2(__m128d x, size_t c) const {
+        for (size_t s = 0; s < n_sec; ++s) {
+            const Biquad& q = sec[s];
+            if (df1) {
+                double* x1 = z + 4 * s * n + c;
+                double* x2 = x1 + n;
+                double* y1 = x2 + n;
+                double* y2 = y1 + n;
+                __m128d px1 = _mm_loadu_pd(x1);
+                __m128d px2 = _mm_loadu_pd(x2);
+                __m128d py1 = _mm_loadu_pd(y1);
+                __m128d py2 = _mm_loadu_pd(y2);
+
+                __m128d y = _mm_mul_pd(_mm_set1_pd(q.b0), x);
+                y = _mm_add_pd(y, _mm_mul_pd(_mm_set1_pd(q.b1), px1));
+                y = _mm_add_pd(y, _mm_mul_pd(_mm_set1_pd(q.b2), px2));
+                y = _mm_sub_pd(y, _mm_mul_pd(_mm_set1_pd(q.a1), py1));
+                y = _mm_sub_pd(y, _mm_mul_pd(_mm_set1_pd(q.a2), py2));
+
+                _mm_storeu_pd(x2, px1);
+                _mm_storeu_pd(x1, x);
+                _mm_storeu_pd(y2, py1);
+                _mm_storeu_pd(y1, y);
+                x = y;
+                continue;
+            }
+            double* z1 = z + 2 * s * n + c;
+            double* z2 = z1 + n;
+            __m128d y = _mm_add_pd(_mm_mul_pd(_mm_set1_pd(q.b0), x), _mm_loadu_pd(z1));
+            _mm_storeu_pd(z1, _mm_add_pd(_mm_sub_pd(_mm_mul_pd(_mm_set1_pd(q.b1), x),
+                                                    _mm_mul_pd(_mm_set1_pd(q.a1), y)),
+                                         _mm_loadu_pd(z2)));
+            _mm_storeu_pd(z2, _mm_sub_pd(_mm_mul_pd(_mm_set1_pd(q.b2), x), _mm_mul_pd(_mm_set1_pd(q.a2), y)));
+            x = y;
+        }
+        return x;
+    }
+    HUB_TARGET_SSE2 __m128 sse2(__m128 v, size_t c) const {
+        __m128d lo = step2(_mm_cvtps_pd(v), c);
+        __m128d hi = step2(_mm_cvtps_pd(_mm_movehl_ps(v, v)), c + 2);
+        return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+    }
+    HUB_TARGET_AVX2 __m128 avx2(__m128 v, size_t c) const {
+        __m256d x = _mm256_cvtps_pd(v);
+        for (size_t s = 0; s < n_sec; ++s) {
+            const Biquad& q = sec[s];
+            if (df1) {
+                double* x1 = z + 4 * s * n + c;
+                double* x2 = x1 + n;
+                double* y1 = x2 + n;
+                double* y2 = y1 + n;
+                __m256d px1 = _mm256_loadu_pd(x1);
+                __m256d px2 = _mm256_loadu_pd(x2);
+                __m256d py1 = _mm256_loadu_pd(y1);
+                __m256d py2 = _mm256_loadu_pd(y2);
+
+                __m256d y = _mm256_mul_pd(_mm256_set1_pd(q.b0), x);
+                y = _mm256_add_pd(y, _mm256_mul_pd(_mm256_set1_pd(q.b1), px1));
+                y = _mm256_add_pd(y, _mm256_mul_pd(_mm256_set1_pd(q.b2), px2));
+                y = _mm256_sub_pd(y, _mm256_mul_pd(_mm256_set1_pd(q.a1), py1));
+                y = _mm256_sub_pd(y, _mm256_mul_pd(_mm256_set1_pd(q.a2), py2));
+
+                _mm256_storeu_pd(x2, px1);
+                _mm256_storeu_pd(x1, x);
+                _mm256_storeu_pd(y2, py1);
+                _mm256_storeu_pd(y1, y);
+                x = y;
+                continue;
+            }
+            double* z1 = z + 2 * s * n + c;
+            double* z2 = z1 + n;
+            __m256d y = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(q.b0), x), _mm256_loadu_pd(z1));
+            _mm256_storeu_pd(z1, _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(q.b1), x),
+                                                             _mm256_mul_pd(_mm256_set1_pd(q.a1), y)),
+                                               _mm256_loadu_pd(z2)));
+            _mm256_storeu_pd(z2, _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(q.b2), x),
+                                               _mm256_mul_pd(_mm256_set1_pd(q.a2), y)));
+            x = y;
+        }
+        return _mm256_cvtpd_ps(x);
+    }
+#endif
+};
+
+struct BiasOp {
+    const float* bias;
+
+    float scalar(float v, size_t c) const { return v - bias[c]; }
+#ifdef HUB_PIPELINE_X86
+    HUB_TARGET_SSE2 __m128 sse2(__m128 v, size_t c) const { return _mm_sub_ps(v, _mm_loadu_ps(bias + c)); }
+    HUB_TARGET_AVX2 __m128 avx2(__m128 v, size_t c) const { return sse2(v, c); }
+#endif
+};
+
+// Stage left out of a specialized chain.
+struct NoOp {
+    float scalar(float v, size_t) const { return v; }
+#ifdef HUB_PIPELINE_X86
+    __m128 sse2(__m128 v, size_t) const { return v; }
+    __m128 avx2(__m128 v, size_t) const { return v; }
+#endif
+};
+
+#ifdef HUB_PIPELINE_X86
+
+template <class... Ops>
+HUB_TARGET_SSE2 static size_t row_sse2(float* x, size_t n, const Ops&... ops) {
+    size_t c = 0;
+    for (; c + 4 <= n; c += 4) {
+        __m128 v = _mm_loadu_ps(x + c);
+        ((v = ops.sse2(v, c)), ...);
+        _mm_storeu_ps(x + c, v);
+    }
+    return c;
+}
 
-    notch_inited_ = false;
-    nx1_.clear(); nx2_.clear(); ny1_.clear(); ny2_.clear();
+template <class... Ops>
+HUB_TARGET_AVX2 static size_t row_avx2(float* x, size_t n, const Ops&... ops) {
+    size_t c = 0;
+    for (; c + 4 <= n; c += 4) {
+        __m128 v = _mm_loadu_ps(x + c);
+        ((v = ops.avx2(v, c)), ...);
+        _mm_storeu_ps(x + c, v);
+    }
+    return c;
+}
+
+#endif
+
+template <class... Ops>
+static void run_row(SimdLevel l, float* x, size_t n, const Ops&... ops) {
+    size_t c = 0;
+#ifdef HUB_PIPELINE_X86
+    if (l == SimdLevel::Avx2) c = row_avx2(x, n, ops...);
+    else if (l == SimdLevel::Sse2) c = row_sse2(x, n, ops...);
+#else
+    (void)l;
+#endif
+    for (; c < n; ++c) {
+        float v = x[c];
+        ((v = ops.scalar(v, c)), ...);
+        x[c] = v;
+    }
+}
+
+// ---- Specialized chains ------------------------------------------------------
+//
+// One instantiation per subset of MA, EMA, SOS (notch or IIR), bias, in that
+// order, picked by bit mask at run time. Left-out stages compile to nothing.
+
+// Position of a stage kind in that order.
+static int fuse_slot(StageKind k) {
+    switch (k) {
+    case StageKind::MA: return 0;
+    case StageKind::EMA: return 1;
+    case StageKind::Notch:
+    case StageKind::Iir: return 2;
+    case StageKind::Bias: return 3;
+    case StageKind::Fir:
+    case StageKind::Median:
+    case StageKind::Hampel: break;  // generic path only
+    }
+    return -1;
+}
+
+struct FusedChain {
+    float* ma_ring = nullptr;
+    double* ma_sum = nullptr;
+    double* ma_comp = nullptr;
+    size_t ma_win = 1;
+    size_t* ma_idx = nullptr;
+    size_t* ma_since = nullptr;
+
+    EmaOp ema{nullptr, 0.0f};
+    SosOp sos{nullptr, 0, nullptr, 0, false};
+    BiasOp bias{nullptr};
+};
+
+template <bool On, class F>
+static auto pick(F make) {
+    if constexpr (On) return make();
+    else return NoOp{};
+}
+
+template <int M>
+static void fused_rows(SimdLevel l, float* x, size_t nf, size_t n, const FusedChain& ch) {
+    constexpr bool kMa = (M & 1) != 0;
+    constexpr bool kEma = (M & 2) != 0;
+    constexpr bool kSos = (M & 4) != 0;
+    constexpr bool kBias = (M & 8) != 0;
+
+    const auto ema = pick<kEma>([&] { return ch.ema; });
+    const auto sos = pick<kSos>([&] { return ch.sos; });
+    const auto bias = pick<kBias>([&] { return ch.bias; });
+
+    for (size_t i = 0; i < nf; ++i, x += n) {
+        const auto ma = pick<kMa>([&] {
+            return MaOp{ch.ma_ring + *ch.ma_idx * n, ch.ma_sum, (double)ch.ma_win};
+        });
+        run_row(l, x, n, ma, ema, sos, bias);
+        if (kMa) {
+            if (++*ch.ma_idx >= ch.ma_win) *ch.ma_idx = 0;
+            if (++*ch.ma_since >= MAFilter::resync_interval(ch.ma_win)) {
+                *ch.ma_since = 0;
+                MAFilter::window_sums(ch.ma_ring, n, ch.ma_win, ch.ma_sum, ch.ma_comp);
+            }
+        }
+    }
+}
+
+using FusedFn = void (*)(SimdLevel, float*, size_t, size_t, const FusedChain&);
+
+template <size_t... M>
+static constexpr std::array<FusedFn, sizeof...(M)> fused_table(std::index_sequence<M...>) {
+    return {{&fused_rows<(int)M>...}};
+}
 
+static constexpr auto kFused = fused_table(std::make_index_sequence<16>{});
+
+// ---- Pipeline ----------------------------------------------------------------
+
+SimdLevel Pipeline::detected_simd() {
+#if defined(HUB_PIPELINE_X86) && defined(_MSC_VER) && !defined(__clang__)
+    static const SimdLevel level = []() {
+        int r[4] = {0, 0, 0, 0};
+        __cpuid(r, 0);
+        const int max_leaf = r[0];
+        __cpuid(r, 1);
+        const bool sse2 = (r[3] >> 26) & 1;
+        const bool osxsave_avx = ((r[2] >> 27) & 1) && ((r[2] >> 28) & 1);
+        bool avx2 = false;
+        if (osxsave_avx && max_leaf >= 7 && (_xgetbv(0) & 6) == 6) {
+            __cpuidex(r, 7, 0);
+            avx2 = (r[1] >> 5) & 1;
+        }
+        return avx2 ? SimdLevel::Avx2 : (sse2 ? SimdLevel::Sse2 : SimdLevel::Scalar);
+    }();
+    return level;
+#elif defined(HUB_PIPELINE_X86)
+    static const SimdLevel level = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::Avx2;
+        if (__builtin_cpu_supports("sse2")) return SimdLevel::Sse2;
+        return SimdLevel::Scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+void Pipeline::set_simd(SimdLevel level) {
+    simd_ = ((int)level < (int)detected_simd()) ? level : detected_simd();
+}
+
+void Pipeline::reset() {
+    n_ch_ = 0;
+    for (auto& st : stages_) {
+        st.ma.reset();
+        st.ema.reset();
+        st.sos.reset();
+        st.fir.reset();
+        st.median.reset();
+        st.hampel.reset();
+    }
     bias_.reset();
 }
 
+static std::vector<StageSpec> stages_from_flags(const PipelineConfig& cfg) {
+    std::vector<StageSpec> out;
+    StageSpec s;
+    s.ma_win = cfg.ma_win;
+    s.ema_alpha = cfg.ema_alpha;
+    s.notch_f0 = cfg.notch_f0;
+    s.notch_q = cfg.notch_q;
+    s.notch_harmonics = cfg.notch_harmonics;
+
+    if (cfg.enable_ma) { s.kind = StageKind::MA; out.push_back(s); }
+    if (cfg.enable_ema) { s.kind = StageKind::EMA; out.push_back(s); }
+    if (cfg.enable_notch) { s.kind = StageKind::Notch; out.push_back(s); }
+    if (cfg.enable_bias) { s.kind = StageKind::Bias; out.push_back(s); }
+    return out;
+}
+
+// Taps of a FIR stage: its loaded kernel, the file (specs built in code), or the
+// windowed-sinc design. A file that cannot be read leaves no taps (pass-through).
+static std::vector<double> fir_kernel_for(const StageSpec& sp, double fs_hz) {
+    if (!sp.fir_kernel.empty()) return sp.fir_kernel;
+    std::vector<double> taps;
+    if (!sp.fir_path.empty()) {
+        std::string err;
+        load_fir_kernel(sp.fir_path, taps, err);
+        return taps;
+    }
+    return design_fir(sp.fir_band, sp.fir_taps, fs_hz, sp.fir_f1, sp.fir_f2);
+}
+
 void Pipeline::set_config(const PipelineConfig& cfg) {
     cfg_ = cfg;
     if (cfg_.ma_win < 1) cfg_.ma_win = 1;
-    update_notch_coeff();
+
+    std::vector<StageSpec> specs = cfg_.stages.empty() ? stages_from_flags(cfg_) : cfg_.stages;
+    bool has_bias = false;
+    for (size_t i = 0; i < specs.size();) {
+        if (specs[i].kind == StageKind::Bias) {
+            if (has_bias) { specs.erase(specs.begin() + (long)i); continue; }
+            has_bias = true;
+        }
+        if (specs[i].ma_win < 1) specs[i].ma_win = 1;
+        if (specs[i].med_win < 1) specs[i].med_win = 1;
+        ++i;
+    }
+
+    // The k-th stage of a kind inherits the state of the previous k-th stage of
+    // that kind, so toggling one stage does not restart the others.
+    std::vector<Stage> next(specs.size());
+    size_t seen[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    for (size_t i = 0; i < specs.size(); ++i) {
+        const int kind = (int)specs[i].kind;
+        size_t k = seen[kind]++;
+        for (auto& old : stages_) {
+            if (old.spec.kind != specs[i].kind) continue;
+            if (k-- == 0) {
+                next[i] = std::move(old);
+                break;
+            }
+        }
+        next[i].spec = specs[i];
+        if (specs[i].kind == StageKind::Fir) next[i].fir_kernel = fir_kernel_for(specs[i], cfg_.fs_hz);
+        configure_stage(next[i]);
+    }
+    stages_ = std::move(next);
+    specs_ = std::move(specs);
+
+    delay_ = 0.0;
+    for (const auto& st : stages_) {
+        if (st.spec.kind == StageKind::MA) delay_ += 0.5 * (double)(st.spec.ma_win - 1);
+        if (st.spec.kind == StageKind::Median) delay_ += 0.5 * (double)(st.spec.med_win - 1);
+        if (st.spec.kind == StageKind::Fir && !st.fir_kernel.empty()) {
+            const size_t taps = st.fir_kernel.size();
+            const size_t fft = fir_fft_size(taps);
+            delay_ += fir_group_delay(st.fir_kernel) + (fft ? (double)(fft - taps) : 0.0);
+        }
+    }
+
+    fused_mask_ = 0;
+    int last = -1;
+    for (const auto& sp : specs_) {
+        const int slot = fuse_slot(sp.kind);
+        if (slot <= last) {
+            fused_mask_ = -1;
+            break;
+        }
+        last = slot;
+        fused_mask_ |= 1 << slot;
+    }
+}
+
+// Applies st.spec, keeping the filter state when the shape still fits. Notch
+// and IIR coefficients are only computed here.
+void Pipeline::configure_stage(Stage& st) {
+    if (n_ch_ == 0) return;
+    const StageSpec& sp = st.spec;
+
+    switch (sp.kind) {
+    case StageKind::MA:
+        if (!st.ma.ready() || st.ma.n_ch_ != n_ch_ || st.ma.win_len() != sp.ma_win) {
+            st.ma.configure(n_ch_, sp.ma_win);
+        }
+        break;
+    case StageKind::EMA:
+        if (!st.ema.ready() || st.ema.n_ch_ != n_ch_) st.ema.configure(n_ch_, sp.ema_alpha);
+        else st.ema.set_alpha(sp.ema_alpha);
+        break;
+    case StageKind::Notch:
+    case StageKind::Iir: {
+        std::vector<Biquad> sec;
+        if (sp.kind == StageKind::Notch && sp.notch_harmonics > 1) sec = design_hum_bank(cfg_.fs_hz, sp.notch_f0, sp.notch_harmonics, sp.notch_q);
+        else if (sp.kind == StageKind::Notch) sec.push_back(design_notch(cfg_.fs_hz, sp.notch_f0, sp.notch_q));
+        else sec = design_iir(sp.iir_band, sp.iir_order, cfg_.fs_hz, sp.iir_f1, sp.iir_f2, sp.iir_ripple_db);
+
+        // Edges the sample rate cannot represent leave the stage a pass-through.
+        // A single notch keeps direct form I, so enable_notch output is unchanged.
+        const SosForm form = sp.kind == StageKind::Notch && sp.notch_harmonics <= 1 ? SosForm::Df1 : SosForm::Tdf2;
+        if (!st.sos.ready() || st.sos.n_ch_ != n_ch_ || st.sos.form() != form) st.sos.configure(n_ch_, sec, form);
+        else st.sos.set_sections(sec);
+        break;
+    }
+    case StageKind::Fir:
+        if (!st.fir.ready() || st.fir.n_ch_ != n_ch_ || st.fir.kernel() != st.fir_kernel) {
+            st.fir.configure(n_ch_, st.fir_kernel);
+        }
+        break;
+    case StageKind::Median:
+        if (!st.median.ready() || st.median.n_ch_ != n_ch_ || st.median.win_len() != sp.med_win) {
+            st.median.configure(n_ch_, sp.med_win);
+        }
+        break;
+    case StageKind::Hampel:
+        if (!st.hampel.ready() || st.hampel.n_ch_ != n_ch_ || st.hampel.win_len() != sp.med_win) {
+            st.hampel.configure(n_ch_, sp.med_win, sp.hampel_k);
+        } else {
+            st.hampel.set_threshold(sp.hampel_k);
+        }
+        break;
+    case StageKind::Bias:
+        break;
+    }
 }
 
 void Pipeline::ensure_initialized(size_t n_ch) {
@@ -30,172 +538,378 @@ void Pipeline::ensure_initialized(size_t n_ch) {
 
     if (n_ch_ != n_ch) {
         n_ch_ = n_ch;
-        ma_inited_ = false;
-        ema_inited_ = false;
-        notch_inited_ = false;
-
-        ma_pos_ = 0;
-        ma_ring_.clear();
-        ma_sum_.clear();
-        ema_state_.clear();
-        nx1_.clear(); nx2_.clear(); ny1_.clear(); ny2_.clear();
+        for (auto& st : stages_) configure_stage(st);
     }
 
     bias_.configure(n_ch_);
-    ensure_ma();
-    ensure_ema();
-    ensure_notch();
 }
 
-void Pipeline::ensure_ma() {
-    if (!cfg_.enable_ma) return;
-    if (n_ch_ == 0) return;
+void Pipeline::prepare(size_t n_ch) {
+    if (n_ch_ == 0 || n_ch != n_ch_) ensure_initialized(n_ch);
+}
+
+void Pipeline::process_row(float* x) {
+    const size_t n = n_ch_;
+    if (n == 0) return;
 
-    size_t win = cfg_.ma_win;
-    if (win < 1) win = 1;
+    bool captured = false;
 
-    size_t need = n_ch_ * win;
-    if (ma_ring_.size() != need) {
-        ma_ring_.assign(need, 0.0f);
-        ma_sum_.assign(n_ch_, 0.0);
-        ma_pos_ = 0;
-        ma_inited_ = false;
+    for (auto& st : stages_) {
+        switch (st.spec.kind) {
+        case StageKind::MA: {
+            MAFilter& f = st.ma;
+            if (!f.primed_) {
+                f.prime(x);
+                break;
+            }
+            run_row(simd_, x, n, MaOp{f.ring_.data() + f.idx_ * n, f.sum_.data(), (double)f.win_len_});
+            if (++f.idx_ >= f.win_len_) f.idx_ = 0;
+            if (++f.since_resync_ >= MAFilter::resync_interval(f.win_len_)) {
+                f.since_resync_ = 0;
+                MAFilter::window_sums(f.ring_.data(), n, f.win_len_, f.sum_.data(), f.comp_.data());
+            }
+            break;
+        }
+        case StageKind::EMA: {
+            EMAFilter& f = st.ema;
+            if (!f.primed_) {
+                std::memcpy(f.y_.data(), x, n * sizeof(float));
+                f.primed_ = true;
+                break;
+            }
+            run_row(simd_, x, n, EmaOp{f.y_.data(), f.alpha_});
+            break;
+        }
+        case StageKind::Notch:
+        case StageKind::Iir:
+            run_row(simd_, x, n, SosOp{st.sos.sec_.data(), st.sos.sec_.size(), st.sos.z_.data(), n,
+                                       st.sos.form_ == SosForm::Df1});
+            break;
+        case StageKind::Fir:
+            st.fir.process_inplace(x, n);
+            break;
+        case StageKind::Median:
+            st.median.process_inplace(x, n);
+            break;
+        case StageKind::Hampel:
+            st.hampel.process_inplace(x, n);
+            break;
+        case StageKind::Bias:
+            if (bias_.capturing()) bias_.update_capture(x, n);
+            captured = true;
+            if (bias_.has_bias()) run_row(simd_, x, n, BiasOp{bias_.bias().data()});
+            break;
+        }
     }
+
+    // Without a bias stage the capture sees the end of the chain.
+    if (!captured && bias_.capturing()) bias_.update_capture(x, n);
 }
 
-void Pipeline::ensure_ema() {
-    if (!cfg_.enable_ema) return;
-    if (n_ch_ == 0) return;
-    if (ema_state_.size() != n_ch_) {
-        ema_state_.assign(n_ch_, 0.0f);
-        ema_inited_ = false;
+bool Pipeline::process_fused(FrameBlock& blk) {
+    const size_t n = n_ch_;
+    size_t i = 0;
+
+    // Priming and bias capture take the generic path.
+    auto ready = [this]() {
+        if (bias_.capturing()) return false;
+        for (const auto& st : stages_) {
+            if (st.spec.kind == StageKind::MA && !st.ma.primed_) return false;
+            if (st.spec.kind == StageKind::EMA && !st.ema.primed_) return false;
+        }
+        return true;
+    };
+    while (i < blk.n_frames && !ready()) process_row(blk.row(i++));
+    if (i == blk.n_frames) return true;
+
+    FusedChain ch;
+    int mask = fused_mask_;
+    for (auto& st : stages_) {
+        switch (st.spec.kind) {
+        case StageKind::MA:
+            ch.ma_ring = st.ma.ring_.data();
+            ch.ma_sum = st.ma.sum_.data();
+            ch.ma_comp = st.ma.comp_.data();
+            ch.ma_win = st.ma.win_len_;
+            ch.ma_idx = &st.ma.idx_;
+            ch.ma_since = &st.ma.since_resync_;
+            break;
+        case StageKind::EMA:
+            ch.ema = EmaOp{st.ema.y_.data(), st.ema.alpha_};
+            break;
+        case StageKind::Notch:
+        case StageKind::Iir:
+            ch.sos = SosOp{st.sos.sec_.data(), st.sos.sec_.size(), st.sos.z_.data(), n,
+                           st.sos.form_ == SosForm::Df1};
+            break;
+        case StageKind::Bias:
+            if (bias_.has_bias()) ch.bias = BiasOp{bias_.bias().data()};
+            else mask &= ~(1 << fuse_slot(StageKind::Bias));
+            break;
+        case StageKind::Fir:
+        case StageKind::Median:
+        case StageKind::Hampel:
+            break;
+        }
     }
+
+    kFused[(size_t)mask](simd_, blk.row(i), blk.n_frames - i, n, ch);
+    return true;
+}
+
+PipelineOut Pipeline::process(uint64_t t_ns, const std::vector<float>& in) {
+    PipelineOut out;
+    out.frame.t_ns = t_ns;
+    out.frame.x = in;
+    process(out.frame.x.data(), out.frame.x.size());
+    return out;
 }
 
-void Pipeline::update_notch_coeff() {
-    if (!cfg_.enable_notch) return;
+void Pipeline::process(float* x, size_t n) {
+    if (n == 0) return;
+    prepare(n);
+    process_row(x);
+}
 
-    double fs = cfg_.fs_hz;
-    double f0 = cfg_.notch_f0;
-    double Q  = cfg_.notch_q;
+void Pipeline::process(const float* in, float* out, size_t n) {
+    if (in != out) std::memmove(out, in, n * sizeof(float));
+    process(out, n);
+}
 
-    if (fs <= 1e-6) fs = 200.0;
-    if (f0 <= 1e-6) f0 = 60.0;
-    if (Q  <= 1e-6) Q  = 30.0;
+void Pipeline::process_block(FrameBlock& blk) {
+    if (blk.n_frames == 0 || blk.n_ch == 0) return;
 
-    double w0 = 2.0 * 3.14159265358979323846 * (f0 / fs);
-    double c = std::cos(w0);
-    double s = std::sin(w0);
-    double alpha = s / (2.0 * Q);
+    prepare(blk.n_ch);
 
-    double b0 = 1.0;
-    double b1 = -2.0 * c;
-    double b2 = 1.0;
-    double a0 = 1.0 + alpha;
-    double a1 = -2.0 * c;
-    double a2 = 1.0 - alpha;
+    if (fused_mask_ >= 0 && process_fused(blk)) return;
 
-    b0_ = b0 / a0;
-    b1_ = b1 / a0;
-    b2_ = b2 / a0;
-    a1_ = a1 / a0;
-    a2_ = a2 / a0;
+    for (size_t i = 0; i < blk.n_frames; ++i) process_row(blk.row(i));
 }
 
-void Pipeline::ensure_notch() {
-    if (!cfg_.enable_notch) return;
-    if (n_ch_ == 0) return;
+void Pipeline::begin_bias_capture(size_t frames) {
+    bias_.begin_capture(frames);
+}
 
-    if (nx1_.size() != n_ch_) {
-        nx1_.assign(n_ch_, 0.0);
-        nx2_.assign(n_ch_, 0.0);
-        ny1_.assign(n_ch_, 0.0);
-        ny2_.assign(n_ch_, 0.0);
-        notch_inited_ = true;
-    }
+// ---- Chain spec --------------------------------------------------------------
+
+static std::string trim(const std::string& s) {
+    size_t a = 0;
+    size_t b = s.size();
+    while (a < b && std::isspace((unsigned char)s[a])) ++a;
+    while (b > a && std::isspace((unsigned char)s[b - 1])) --b;
+    return s.substr(a, b - a);
 }
 
-PipelineOut Pipeline::process(uint64_t t_ns, const std::vector<float>& in) {
-    PipelineOut out;
-    out.frame.t_ns = t_ns;
-    out.frame.x = in;
+static std::string trim_lower(const std::string& s) {
+    std::string out = trim(s);
+    for (auto& c : out) c = (char)std::tolower((unsigned char)c);
+    return out;
+}
 
-    if (n_ch_ == 0) ensure_initialized(in.size());
-    if (in.size() != n_ch_) ensure_initialized(in.size());
+static std::vector<std::string> split(const std::string& s, char sep, bool lower = true) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    for (;;) {
+        size_t p = s.find(sep, start);
+        std::string part = s.substr(start, p == std::string::npos ? std::string::npos : p - start);
+        out.push_back(lower ? trim_lower(part) : trim(part));
+        if (p == std::string::npos) break;
+        start = p + 1;
+    }
+    return out;
+}
 
-    auto& x = out.frame.x;
+static bool parse_number(const std::string& s, double& v) {
+    if (s.empty()) return false;
+    char* end = nullptr;
+    v = std::strtod(s.c_str(), &end);
+    return end && *end == '\0' && std::isfinite(v);
+}
 
-    // MA
-    if (cfg_.enable_ma) {
-        ensure_ma();
-        size_t win = cfg_.ma_win;
-        if (!ma_inited_) {
-            for (size_t ch = 0; ch < n_ch_; ++ch) {
-                ma_sum_[ch] = (double)win * (double)x[ch];
+bool parse_stage_chain(const std::string& spec, std::vector<StageSpec>& out, std::string& err) {
+    out.clear();
+    if (trim_lower(spec).empty()) return true;
+
+    bool has_bias = false;
+    for (const auto& raw : split(spec, ',', false)) {
+        const std::string tok = trim_lower(raw);
+        auto f = split(tok, ':');
+        const std::string& name = f[0];
+        const size_t nargs = f.size() - 1;
+        StageSpec s;
+        double v = 0;
+
+        if (name == "ma") {
+            if (nargs != 1 || !parse_number(f[1], v) || v < 1 || v != std::floor(v)) {
+                err = "ma needs a window length: ma:N";
+                return false;
+            }
+            s.kind = StageKind::MA;
+            s.ma_win = (size_t)v;
+        } else if (name == "ema") {
+            if (nargs != 1 || !parse_number(f[1], v) || v <= 0 || v > 1) {
+                err = "ema needs an alpha in (0, 1]: ema:A";
+                return false;
             }
-            for (size_t k = 0; k < win; ++k) {
-                for (size_t ch = 0; ch < n_ch_; ++ch) {
-                    ma_ring_[k * n_ch_ + ch] = x[ch];
+            s.kind = StageKind::EMA;
+            s.ema_alpha = (float)v;
+        } else if (name == "notch") {
+            if (nargs < 1 || nargs > 2 || !parse_number(f[1], v) || v <= 0) {
+                err = "notch needs a frequency: notch:F0[:Q]";
+                return false;
+            }
+            s.kind = StageKind::Notch;
+            s.notch_f0 = v;
+            if (nargs == 2) {
+                if (!parse_number(f[2], v) || v <= 0) {
+                    err = "notch Q must be positive";
+                    return false;
                 }
+                s.notch_q = v;
             }
-            ma_pos_ = 0;
-            ma_inited_ = true;
-        } else {
-            size_t base = ma_pos_ * n_ch_;
-            for (size_t ch = 0; ch < n_ch_; ++ch) {
-                float oldv = ma_ring_[base + ch];
-                ma_ring_[base + ch] = x[ch];
-                ma_sum_[ch] += (double)x[ch] - (double)oldv;
-                x[ch] = (float)(ma_sum_[ch] / (double)win);
+        } else if (name == "hum") {
+            double h = 4, q = 30;
+            if (nargs < 1 || nargs > 3 || !parse_number(f[1], v) || v <= 0) {
+                err = "hum needs a line frequency: hum:F0[:HARMONICS[:Q]]";
+                return false;
+            }
+            if (nargs > 1 && (!parse_number(f[2], h) || h < 1 || h > 32 || h != std::floor(h))) {
+                err = "hum harmonics must be 1..32";
+                return false;
+            }
+            if (nargs > 2 && (!parse_number(f[3], q) || q <= 0)) {
+                err = "hum Q must be positive";
+                return false;
+            }
+            s.kind = StageKind::Notch;
+            s.notch_f0 = v;
+            s.notch_harmonics = (int)h;
+            s.notch_q = q;
+        } else if (name == "lp" || name == "hp" || name == "bp") {
+            const bool bp = name == "bp";
+            const size_t nedges = bp ? 2 : 1;
+            double f1 = 0, f2 = 0, order = 2, ripple = 0;
+            if (nargs < nedges || nargs > nedges + 2 || !parse_number(f[1], f1) || f1 <= 0 ||
+                (bp && (!parse_number(f[2], f2) || f2 <= f1))) {
+                err = bp ? "bp needs two rising edges: bp:F1:F2[:ORDER[:RIPPLE_DB]]"
+                         : name + " needs a cutoff: " + name + ":FC[:ORDER[:RIPPLE_DB]]";
+                return false;
+            }
+            if (nargs > nedges && (!parse_number(f[nedges + 1], order) || order < 1 || order > 20 ||
+                                   order != std::floor(order))) {
+                err = name + " order must be 1..20";
+                return false;
+            }
+            if (nargs > nedges + 1 && (!parse_number(f[nedges + 2], ripple) || ripple < 0)) {
+                err = name + " ripple must be >= 0 dB";
+                return false;
+            }
+            s.kind = StageKind::Iir;
+            s.iir_band = bp ? FilterBand::BandPass : (name == "lp" ? FilterBand::LowPass : FilterBand::HighPass);
+            s.iir_f1 = f1;
+            s.iir_f2 = f2;
+            s.iir_order = (int)order;
+            s.iir_ripple_db = ripple;
+        } else if (name == "fir") {
+            // The path keeps its case and may contain ':' (drive letters).
+            const std::string path = nargs ? trim(raw.substr(raw.find(':') + 1)) : std::string();
+            if (path.empty()) {
+                err = "fir needs a kernel file: fir:PATH";
+                return false;
+            }
+            s.kind = StageKind::Fir;
+            s.fir_path = path;
+            if (!load_fir_kernel(path, s.fir_kernel, err)) return false;
+        } else if (name == "firlp" || name == "firhp" || name == "firbp") {
+            const bool bp = name == "firbp";
+            const size_t nedges = bp ? 2 : 1;
+            double f1 = 0, f2 = 0, taps = 101;
+            if (nargs < nedges || nargs > nedges + 1 || !parse_number(f[1], f1) || f1 <= 0 ||
+                (bp && (!parse_number(f[2], f2) || f2 <= f1))) {
+                err = bp ? "firbp needs two rising edges: firbp:F1:F2[:TAPS]"
+                         : name + " needs a cutoff: " + name + ":FC[:TAPS]";
+                return false;
+            }
+            if (nargs > nedges && (!parse_number(f[nedges + 1], taps) || taps < 1 || taps > 65536 ||
+                                   taps != std::floor(taps))) {
+                err = name + " taps must be 1..65536";
+                return false;
+            }
+            s.kind = StageKind::Fir;
+            s.fir_band = bp ? FilterBand::BandPass : (name == "firlp" ? FilterBand::LowPass : FilterBand::HighPass);
+            s.fir_f1 = f1;
+            s.fir_f2 = f2;
+            s.fir_taps = (size_t)taps;
+        } else if (name == "median" || name == "hampel") {
+            const bool hampel = name == "hampel";
+            if (nargs < 1 || nargs > (hampel ? 2u : 1u) || !parse_number(f[1], v) || v < 1 || v > 4096 ||
+                v != std::floor(v)) {
+                err = hampel ? "hampel needs a window of 1..4096: hampel:W[:K]" : "median needs a window of 1..4096: median:W";
+                return false;
             }
-            ma_pos_ = (ma_pos_ + 1) % win;
+            s.kind = hampel ? StageKind::Hampel : StageKind::Median;
+            s.med_win = (size_t)v;
+            if (nargs == 2) {
+                if (!parse_number(f[2], v) || v <= 0) {
+                    err = "hampel K must be positive";
+                    return false;
+                }
+                s.hampel_k = (float)v;
+            }
+        } else if (name == "bias") {
+            if (nargs != 0 || has_bias) {
+                err = "bias takes no arguments and may appear once";
+                return false;
+            }
+            s.kind = StageKind::Bias;
+            has_bias = true;
+        } else {
+            err = tok.empty() ? "empty stage" : "unknown stage '" + name + "'";
+            return false;
         }
+        out.push_back(s);
     }
+    return true;
+}
 
-    // EMA
-    if (cfg_.enable_ema) {
-        ensure_ema();
-        float a = cfg_.ema_alpha;
-        if (!ema_inited_) {
-            ema_state_ = x;
-            ema_inited_ = true;
-        } else {
-            for (size_t ch = 0; ch < n_ch_; ++ch) {
-                ema_state_[ch] = a * x[ch] + (1.0f - a) * ema_state_[ch];
+std::string format_stage_chain(const std::vector<StageSpec>& stages) {
+    std::string out;
+    char buf[64];
+    for (const auto& s : stages) {
+        if (!out.empty()) out += ",";
+        switch (s.kind) {
+        case StageKind::MA: std::snprintf(buf, sizeof(buf), "ma:%zu", s.ma_win); break;
+        case StageKind::EMA: std::snprintf(buf, sizeof(buf), "ema:%g", (double)s.ema_alpha); break;
+        case StageKind::Notch:
+            if (s.notch_harmonics > 1) std::snprintf(buf, sizeof(buf), "hum:%g:%d:%g", s.notch_f0, s.notch_harmonics, s.notch_q);
+            else std::snprintf(buf, sizeof(buf), "notch:%g:%g", s.notch_f0, s.notch_q);
+            break;
+        case StageKind::Bias: std::snprintf(buf, sizeof(buf), "bias"); break;
+        case StageKind::Iir: {
+            static const char* kBand[] = {"lp", "hp", "bp"};
+            int k = std::snprintf(buf, sizeof(buf), "%s:%g", kBand[(int)s.iir_band], s.iir_f1);
+            if (s.iir_band == FilterBand::BandPass) k += std::snprintf(buf + k, sizeof(buf) - (size_t)k, ":%g", s.iir_f2);
+            k += std::snprintf(buf + k, sizeof(buf) - (size_t)k, ":%d", s.iir_order);
+            if (s.iir_ripple_db > 0) std::snprintf(buf + k, sizeof(buf) - (size_t)k, ":%g", s.iir_ripple_db);
+            break;
+        }
+        case StageKind::Median: std::snprintf(buf, sizeof(buf), "median:%zu", s.med_win); break;
+        case StageKind::Hampel: std::snprintf(buf, sizeof(buf), "hampel:%zu:%g", s.med_win, (double)s.hampel_k); break;
+        case StageKind::Fir: {
+            if (!s.fir_path.empty()) {
+                out += "fir:" + s.fir_path;
+                continue;
             }
-            x = ema_state_;
+            static const char* kBand[] = {"firlp", "firhp", "firbp"};
+            int k = std::snprintf(buf, sizeof(buf), "%s:%g", kBand[(int)s.fir_band], s.fir_f1);
+            if (s.fir_band == FilterBand::BandPass) k += std::snprintf(buf + k, sizeof(buf) - (size_t)k, ":%g", s.fir_f2);
+            std::snprintf(buf + k, sizeof(buf) - (size_t)k, ":%zu", s.fir_taps);
+            break;
         }
-    }
-
-    // Notch
-    if (cfg_.enable_notch) {
-        ensure_notch();
-        update_notch_coeff();
-        for (size_t ch = 0; ch < n_ch_; ++ch) {
-            double xn = (double)x[ch];
-            double yn = b0_ * xn + b1_ * nx1_[ch] + b2_ * nx2_[ch]
-                        - a1_ * ny1_[ch] - a2_ * ny2_[ch];
-
-            nx2_[ch] = nx1_[ch];
-            nx1_[ch] = xn;
-            ny2_[ch] = ny1_[ch];
-            ny1_[ch] = yn;
-
-            x[ch] = (float)yn;
         }
+        out += buf;
     }
-
-    // Bias capture/update
-    if (bias_.capturing()) bias_.update_capture(x);
-
-    // Bias apply
-    if (cfg_.enable_bias) bias_.apply_inplace(x);
-
     return out;
 }
 
-void Pipeline::begin_bias_capture(size_t frames) {
-    bias_.begin_capture(frames);
-}
-
 }
@@ -0,0 +1,227 @@
+#include "hub/ReplayReader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace hub {
+
+static inline uint64_t now_ns() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+ReplayReader::~ReplayReader() {
+    close();
+}
+
+CsvLayout ReplayReader::recording_layout() {
+    CsvLayout l;
+    l.time_col = 0;
+    l.time_bits = 0;
+    l.time_unit_s = 1.0;
+    return l;
+}
+
+bool ReplayReader::open(const std::string& path, const ReplayConfig& cfg, std::string& err) {
+    close();
+
+    in_.clear();
+    in_.open(path, std::ios::binary);
+    if (!in_) {
+        err = "cannot open " + path;
+        return false;
+    }
+
+    path_ = path;
+    cfg_ = cfg;
+    if (cfg_.chunk == 0) cfg_.chunk = 4096;
+
+    // The recorder writes a "t,ch0,..." header; anything else is a raw capture.
+    std::getline(in_, line_);
+    if (line_ == "t" || line_.compare(0, 2, "t,") == 0) {
+        format_ = ReplayFormat::Recording;
+        if (in_.eof()) {
+            in_.clear();
+            in_.seekg(0, std::ios::end);
+        }
+        data_pos_ = in_.tellg();
+    } else {
+        format_ = ReplayFormat::Raw;
+        in_.clear();
+        in_.seekg(0);
+        data_pos_ = 0;
+    }
+
+    has_first_ = false;
+    first_t_ = last_t_ = last_dt_ = loop_offset_ = 0.0;
+    raw_pos_ = 0;
+    sent_.store(0);
+    finished_.store(false);
+
+    open_ = true;
+    return true;
+}
+
+void ReplayReader::start(SpscByteRing& ring, DataFn on_data, EndFn on_end) {
+    if (!open_ || thread_.joinable()) return;
+
+    ring_ = &ring;
+    on_data_ = std::move(on_data);
+    on_end_ = std::move(on_end);
+    paced_ = cfg_.speed > 0.0 && (format_ == ReplayFormat::Recording || cfg_.raw_bytes_per_s > 0.0);
+
+    run_.store(true);
+    thread_ = std::thread([this]() { this->run(); });
+}
+
+bool ReplayReader::next_record(std::string& rec, double& t_s) {
+    rec.clear();
+
+    if (format_ == ReplayFormat::Raw) {
+        rec.resize(cfg_.chunk);
+        in_.read(&rec[0], (std::streamsize)cfg_.chunk);
+        size_t got = (size_t)in_.gcount();
+        rec.resize(got);
+        if (got == 0) return false;
+        t_s = cfg_.raw_bytes_per_s > 0.0 ? (double)raw_pos_ / cfg_.raw_bytes_per_s : 0.0;
+        raw_pos_ += got;
+        return true;
+    }
+
+    for (;;) {
+        if (!std::getline(in_, line_)) return false;
+        if (!line_.empty() && line_.back() == '\r') line_.pop_back();
+        if (!line_.empty()) break;
+    }
+
+    // A line without a readable t keeps the previous time (the parser rejects it).
+    char* end = nullptr;
+    double t = std::strtod(line_.c_str(), &end);
+    if (end == line_.c_str()) t = has_first_ ? last_t_ - loop_offset_ : 0.0;
+
+    if (!has_first_) {
+        has_first_ = true;
+        first_t_ = t;
+    }
+    t_s = t + loop_offset_;
+
+    if (loop_offset_ == 0.0) {
+        rec.assign(line_);
+    } else {
+        // Later loops: shift the t column so device time keeps increasing.
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.6f", t_s);
+        size_t comma = line_.find(',');
+        rec.assign(buf);
+        if (comma != std::string::npos) rec.append(line_, comma, std::string::npos);
+    }
+    rec.push_back('\n');
+
+    if (t_s > last_t_) last_dt_ = t_s - last_t_;
+    last_t_ = t_s;
+    return true;
+}
+
+bool ReplayReader::rewind() {
+    in_.clear();
+    in_.seekg(data_pos_);
+    if (!in_) return false;
+
+    if (format_ == ReplayFormat::Recording && has_first_) {
+        loop_offset_ = last_t_ + last_dt_ - first_t_;
+    }
+    return true;
+}
+
+void ReplayReader::flush(std::string& batch) {
+    size_t off = 0;
+    while (off < batch.size()) {
+        char* p = nullptr;
+        size_t span = ring_->write_span(p);
+        if (span == 0) {
+            // Paced: behave like a device and drop. Unpaced: wait for the consumer.
+            if (paced_) {
+                ring_->note_overflow(batch.size() - off);
+                break;
+            }
+            if (!run_.load()) break;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+
+        size_t n = std::min(span, batch.size() - off);
+        std::memcpy(p, batch.data() + off, n);
+        ring_->commit(n);
+        off += n;
+        if (on_data_) on_data_();
+    }
+
+    sent_.fetch_add(batch.size(), std::memory_order_relaxed);
+    batch.clear();
+}
+
+void ReplayReader::run() {
+    std::string batch;
+    std::string rec;
+    double t = 0.0;
+    bool have = false;
+
+    bool started = false;
+    uint64_t start_ns = 0;
+    double t0 = 0.0;
+
+    batch.reserve(cfg_.chunk * 2);
+
+    while (run_.load()) {
+        if (!have) {
+            bool ok = next_record(rec, t);
+            if (!ok && cfg_.loop && rewind()) ok = next_record(rec, t);
+            if (!ok) {
+                flush(batch);
+                finished_.store(true);
+                if (on_end_) on_end_();
+                break;
+            }
+            have = true;
+
+            if (!started) {
+                started = true;
+                start_ns = now_ns();
+                t0 = t;
+            }
+        }
+
+        if (paced_) {
+            double ahead_s = (t - t0) / cfg_.speed;
+            uint64_t due = start_ns + (ahead_s > 0.0 ? (uint64_t)std::llround(ahead_s * 1e9) : 0);
+            uint64_t now = now_ns();
+            if (now < due) {
+                // Nothing more is due: hand over what we have, then wait.
+                flush(batch);
+                uint64_t wait = std::min<uint64_t>(due - now, 10000000ULL);
+                std::this_thread::sleep_for(std::chrono::nanoseconds(wait));
+                continue;
+            }
+        }
+
+        batch += rec;
+        have = false;
+        if (batch.size() >= cfg_.chunk) flush(batch);
+    }
+
+    run_.store(false);
+}
+
+void ReplayReader::close() {
+    run_.store(false);
+    if (thread_.joinable()) thread_.join();
+
+    if (in_.is_open()) in_.close();
+    open_ = false;
+}
+
+}
@@ -0,0 +1,159 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include "hub/Resampler.h"
+
+namespace hub {
+
+void Resampler::reset() {
+    n_ch_ = 0;
+    next_k_ = 0;
+    started_ = false;
+    buf_.clear();
+    buf_.n_ch = 0;
+    first_ = 0;
+    in_period_ns_ = period_ns_;
+}
+
+void Resampler::configure(const ResamplerConfig& cfg) {
+    cfg_ = cfg;
+    if (!(cfg_.fs_hz > 0.0)) cfg_.fs_hz = 200.0;
+    if (cfg_.half_width < 1) cfg_.half_width = 1;
+    period_ns_ = 1e9 / cfg_.fs_hz;
+    whole_ns_ = (uint64_t)std::floor(period_ns_);
+    frac_ns_ = period_ns_ - (double)whole_ns_;
+    reset();
+}
+
+// A pure function of k, so every stream at this rate gets the same times.
+uint64_t Resampler::grid_time(uint64_t k) const {
+    return k * whole_ns_ + (uint64_t)std::floor((double)k * frac_ns_);
+}
+
+uint64_t Resampler::first_grid_at_or_after(uint64_t t) const {
+    uint64_t k = (uint64_t)std::floor((double)t / period_ns_);
+    while (grid_time(k) < t) ++k;
+    while (k > 0 && grid_time(k - 1) >= t) --k;
+    return k;
+}
+
+double Resampler::reach_ns() const {
+    if (cfg_.method == ResampleMethod::Linear) return 0.0;
+    return (double)cfg_.half_width * std::max(period_ns_, in_period_ns_);
+}
+
+double Resampler::latency_s() const {
+    return (cfg_.method == ResampleMethod::Linear ? in_period_ns_ : reach_ns()) * 1e-9;
+}
+
+void Resampler::process(const FrameBlock& in, FrameBlock& out) {
+    out.n_ch = in.n_ch;
+    if (in.n_ch == 0) return;
+    if (in.n_ch != n_ch_) {
+        reset();
+        n_ch_ = in.n_ch;
+        buf_.n_ch = n_ch_;
+        acc_.assign(n_ch_, 0.0);
+    }
+    for (size_t i = 0; i < in.n_frames; ++i) push(in.t_ns[i], in.row(i), out);
+}
+
+void Resampler::push(uint64_t t, const float* x, FrameBlock& out) {
+    const size_t n = buf_.n_frames;
+    if (n > first_) {
+        const uint64_t last = buf_.t_ns[n - 1];
+        if (t <= last) return;
+
+        const double dt = (double)(t - last);
+        if (dt > cfg_.max_gap_s * 1e9) {
+            // Finish what the data before the gap supports, then start over.
+            emit_until(last, out);
+            buf_.clear();
+            first_ = 0;
+            started_ = false;
+        } else {
+            in_period_ns_ += 0.01 * (dt - in_period_ns_);
+        }
+    }
+
+    if (!started_) {
+        next_k_ = first_grid_at_or_after(t);
+        started_ = true;
+    }
+
+    std::memcpy(buf_.append(t), x, n_ch_ * sizeof(float));
+
+    const double reach = reach_ns();
+    if ((double)t >= reach) emit_until(t - (uint64_t)reach, out);
+
+    // Keep what the next grid time can still use.
+    const uint64_t tau = grid_time(next_k_);
+    const uint64_t keep_from = (double)tau > reach ? tau - (uint64_t)reach : 0;
+    while (first_ + 1 < buf_.n_frames && buf_.t_ns[first_ + 1] <= keep_from) ++first_;
+    if (first_ >= 1024 && 2 * first_ >= buf_.n_frames) {
+        const size_t keep = buf_.n_frames - first_;
+        std::memmove(buf_.x.data(), buf_.row(first_), keep * n_ch_ * sizeof(float));
+        std::memmove(buf_.t_ns.data(), buf_.t_ns.data() + first_, keep * sizeof(uint64_t));
+        buf_.n_frames = keep;
+        first_ = 0;
+    }
+}
+
+void Resampler::emit_until(uint64_t t_limit, FrameBlock& out) {
+    for (;;) {
+        const uint64_t tau = grid_time(next_k_);
+        if (tau > t_limit) break;
+        interpolate(tau, out.append(tau));
+        ++next_k_;
+    }
+}
+
+void Resampler::interpolate(uint64_t tau, float* y) {
+    const size_t n = n_ch_;
+    const size_t end = buf_.n_frames;
+
+    if (cfg_.method == ResampleMethod::Linear) {
+        // Last frame at or before tau; the one after it is past tau.
+        size_t a = first_;
+        while (a + 1 < end && buf_.t_ns[a + 1] <= tau) ++a;
+        const float* xa = buf_.row(a);
+        if (buf_.t_ns[a] >= tau || a + 1 >= end) {
+            std::memcpy(y, xa, n * sizeof(float));
+            return;
+        }
+        const float* xb = buf_.row(a + 1);
+        const double w = (double)(tau - buf_.t_ns[a]) / (double)(buf_.t_ns[a + 1] - buf_.t_ns[a]);
+        for (size_t c = 0; c < n; ++c) y[c] = (float)((double)xa[c] + w * ((double)xb[c] - (double)xa[c]));
+        return;
+    }
+
+    const double scale = std::max(period_ns_, in_period_ns_);
+    const double hw = (double)cfg_.half_width;
+    std::fill(acc_.begin(), acc_.end(), 0.0);
+    double wsum = 0.0;
+    for (size_t i = first_; i < end; ++i) {
+        const double u = ((double)buf_.t_ns[i] - (double)tau) / scale;
+        if (u <= -hw) continue;
+        if (u >= hw) break;
+        const double s = u == 0.0 ? 1.0 : std::sin(M_PI * u) / (M_PI * u);
+        // Each frame stands for the half spacings to its neighbours, so
+        // uneven input approximates the convolution integral.
+        const uint64_t lo = i > 0 ? buf_.t_ns[i - 1] : buf_.t_ns[i];
+        const uint64_t hi = i + 1 < end ? buf_.t_ns[i + 1] : buf_.t_ns[i];
+        const double span = hi > lo ? (double)(hi - lo) : in_period_ns_;
+        const double w = span * s * 0.5 * (1.0 + std::cos(M_PI * u / hw));
+        const float* x = buf_.row(i);
+        for (size_t c = 0; c < n; ++c) acc_[c] += w * (double)x[c];
+        wsum += w;
+    }
+
+    if (wsum == 0.0) {
+        // Nothing within reach (cannot happen while the buffer spans tau).
+        std::memcpy(y, buf_.row(end - 1), n * sizeof(float));
+        return;
+    }
+    for (size_t c = 0; c < n; ++c) y[c] = (float)(acc_[c] / wsum);
+}
+
+}
@@ -0,0 +1,345 @@
+#include "hub/SerialReader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/serial.h>
+#endif
+#if defined(__APPLE__)
+#include <IOKit/serial/ioss.h>
+#endif
+#endif
+
+namespace hub {
+
+SerialReader::~SerialReader() {
+    close();
+}
+
+#ifndef _WIN32
+static speed_t to_speed(uint32_t baud) {
+    switch (baud) {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+#ifdef B460800
+    case 460800: return B460800;
+#endif
+#ifdef B500000
+    case 500000: return B500000;
+#endif
+#ifdef B576000
+    case 576000: return B576000;
+#endif
+#ifdef B921600
+    case 921600: return B921600;
+#endif
+#ifdef B1000000
+    case 1000000: return B1000000;
+#endif
+#ifdef B1152000
+    case 1152000: return B1152000;
+#endif
+#ifdef B1500000
+    case 1500000: return B1500000;
+#endif
+#ifdef B2000000
+    case 2000000: return B2000000;
+#endif
+#ifdef B2500000
+    case 2500000: return B2500000;
+#endif
+#ifdef B3000000
+    case 3000000: return B3000000;
+#endif
+#ifdef B3500000
+    case 3500000: return B3500000;
+#endif
+#ifdef B4000000
+    case 4000000: return B4000000;
+#endif
+    default: break;
+    }
+    return 0;
+}
+#endif
+
+bool SerialReader::open(const std::string& port, const SerialConfig& cfg, std::string& err) {
+    close();
+
+    if (port.empty()) {
+        err = "Serial port empty";
+        return false;
+    }
+
+    cfg_ = cfg;
+    if (cfg_.baud == 0) cfg_.baud = 115200;
+    if (cfg_.read_chunk < 64) cfg_.read_chunk = 64;
+
+#ifdef _WIN32
+    std::string path = port;
+    if (path.rfind("\\\\.\\", 0) != 0) path = "\\\\.\\" + path;
+
+    HANDLE h = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (h == INVALID_HANDLE_VALUE) {
+        err = "open failed (error " + std::to_string(GetLastError()) + ")";
+        return false;
+    }
+
+    DWORD inQueue = (DWORD)std::max<size_t>(cfg_.read_chunk * 4, 65536);
+    SetupComm(h, inQueue, 4096);
+
+    DCB dcb{};
+    dcb.DCBlength = sizeof(dcb);
+    GetCommState(h, &dcb);
+    dcb.BaudRate = (DWORD)cfg_.baud;
+    dcb.ByteSize = 8;
+    dcb.Parity = NOPARITY;
+    dcb.StopBits = ONESTOPBIT;
+    dcb.fBinary = TRUE;
+    dcb.fParity = FALSE;
+    dcb.fOutxCtsFlow = FALSE;
+    dcb.fOutxDsrFlow = FALSE;
+    dcb.fDsrSensitivity = FALSE;
+    dcb.fOutX = FALSE;
+    dcb.fInX = FALSE;
+    dcb.fDtrControl = DTR_CONTROL_ENABLE;   // USB-CDC devices often wait for DTR
+    dcb.fRtsControl = RTS_CONTROL_ENABLE;
+    dcb.fAbortOnError = FALSE;
+    if (!SetCommState(h, &dcb)) {
+        err = "baud " + std::to_string(cfg_.baud) + " not accepted (error " + std::to_string(GetLastError()) + ")";
+        CloseHandle(h);
+        return false;
+    }
+
+    COMMTIMEOUTS to{};
+    if (cfg_.low_latency) {
+        // Return as soon as any byte is available, or after 20 ms.
+        to.ReadIntervalTimeout = MAXDWORD;
+        to.ReadTotalTimeoutMultiplier = MAXDWORD;
+        to.ReadTotalTimeoutConstant = 20;
+    } else {
+        // Let bytes accumulate: return after a 5 ms gap or 50 ms total.
+        to.ReadIntervalTimeout = 5;
+        to.ReadTotalTimeoutMultiplier = 0;
+        to.ReadTotalTimeoutConstant = 50;
+    }
+    SetCommTimeouts(h, &to);
+    PurgeComm(h, PURGE_RXCLEAR);
+
+    handle_ = h;
+#else
+    std::string path = port;
+    if (path[0] != '/') path = "/dev/" + path;
+
+    int fd = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        err = std::strerror(errno);
+        return false;
+    }
+
+    termios tio{};
+    if (tcgetattr(fd, &tio) != 0) {
+        err = std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    cfmakeraw(&tio);
+    tio.c_cflag |= (CLOCAL | CREAD);
+    tio.c_cflag &= ~CSTOPB;
+#ifdef CRTSCTS
+    tio.c_cflag &= ~CRTSCTS;
+#endif
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+
+    speed_t sp = to_speed(cfg_.baud);
+    if (sp != 0) {
+        cfsetispeed(&tio, sp);
+        cfsetospeed(&tio, sp);
+    } else {
+#if defined(__APPLE__)
+        cfsetispeed(&tio, B115200);
+        cfsetospeed(&tio, B115200);
+#else
+        err = "unsupported baud " + std::to_string(cfg_.baud);
+        ::close(fd);
+        return false;
+#endif
+    }
+
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        err = std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+#if defined(__APPLE__)
+    if (sp == 0) {
+        speed_t custom = (speed_t)cfg_.baud;
+        if (ioctl(fd, IOSSIOSPEED, &custom) == -1) {
+            err = "unsupported baud " + std::to_string(cfg_.baud);
+            ::close(fd);
+            return false;
+        }
+    }
+#endif
+
+#if defined(__linux__)
+    if (cfg_.low_latency) {
+        // FTDI and friends otherwise hold bytes for up to 16 ms. Not all drivers
+        // support this (cdc_acm does not need it), so failure is ignored.
+        serial_struct ss{};
+        if (ioctl(fd, TIOCGSERIAL, &ss) == 0) {
+            ss.flags |= ASYNC_LOW_LATENCY;
+            ioctl(fd, TIOCSSERIAL, &ss);
+        }
+    }
+#endif
+
+    tcflush(fd, TCIFLUSH);
+    fd_ = fd;
+#endif
+
+    port_ = port;
+    open_ = true;
+    return true;
+}
+
+bool SerialReader::read_some(char* dst, size_t cap, size_t& got, std::string& err) {
+    got = 0;
+#ifdef _WIN32
+    DWORD n = 0;
+    if (!ReadFile((HANDLE)handle_, dst, (DWORD)cap, &n, nullptr)) {
+        err = "read failed (error " + std::to_string(GetLastError()) + ")";
+        return false;
+    }
+    got = (size_t)n;
+    return true;
+#else
+    pollfd pfd{};
+    pfd.fd = fd_;
+    pfd.events = POLLIN;
+
+    int r = ::poll(&pfd, 1, 50);
+    if (r < 0) {
+        if (errno == EINTR) return true;
+        err = std::strerror(errno);
+        return false;
+    }
+    if (r == 0) return true;
+
+    if (pfd.revents & POLLNVAL) {
+        err = "port closed";
+        return false;
+    }
+
+    ssize_t n = ::read(fd_, dst, cap);
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EINTR) return true;
+        err = std::strerror(errno);
+        return false;
+    }
+    if (n == 0) {
+        // Readable but empty: the device went away.
+        err = "device disconnected";
+        return false;
+    }
+    got = (size_t)n;
+    return true;
+#endif
+}
+
+void SerialReader::start(SpscByteRing& ring, DataFn on_data, ErrorFn on_error) {
+    if (!open_ || thread_.joinable()) return;
+
+    ring_ = &ring;
+    on_data_ = std::move(on_data);
+    on_error_ = std::move(on_error);
+
+    run_.store(true);
+    thread_ = std::thread([this]() { this->run(); });
+}
+
+void SerialReader::run() {
+    std::vector<char> scratch(cfg_.read_chunk);
+
+    while (run_.load()) {
+        char* p = nullptr;
+        size_t span = ring_->write_span(p);
+
+        // Ring full: keep draining the port so the OS buffer does not stall,
+        // and account the dropped bytes as overflow.
+        bool to_ring = (span > 0);
+        size_t cap = to_ring ? std::min(span, cfg_.read_chunk) : cfg_.read_chunk;
+        char* dst = to_ring ? p : scratch.data();
+
+        size_t got = 0;
+        std::string err;
+        if (!read_some(dst, cap, got, err)) {
+            if (run_.load() && on_error_) on_error_(err);
+            break;
+        }
+        if (got == 0) continue;
+
+        if (to_ring) {
+            ring_->commit(got);
+            if (on_data_) on_data_();
+        } else {
+            ring_->note_overflow(got);
+        }
+
+        if (!cfg_.low_latency && got < cap / 2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    run_.store(false);
+}
+
+void SerialReader::close() {
+    run_.store(false);
+    if (thread_.joinable()) thread_.join();
+
+#ifdef _WIN32
+    if (handle_) {
+        CloseHandle((HANDLE)handle_);
+        handle_ = nullptr;
+    }
+#else
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+
+    open_ = false;
+    port_.clear();
+    ring_ = nullptr;
+    on_data_ = nullptr;
+    on_error_ = nullptr;
+}
+
+}
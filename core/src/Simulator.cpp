@@ -0,0 +1,200 @@
+#include "hub/Simulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace hub {
+
+static constexpr double kPi = 3.14159265358979323846;
+
+static inline uint64_t now_ns() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+CsvLayout SensorArraySimulator::csv_layout() {
+    CsvLayout l;
+    l.seq_col = 0;
+    l.seq_bits = 16;
+    l.time_col = 1;
+    l.time_bits = 32;
+    l.time_unit_s = 1e-6;
+    return l;
+}
+
+void SensorArraySimulator::reset(const SimConfig& cfg) {
+    cfg_ = cfg;
+    if (cfg_.fs_hz <= 0.0) cfg_.fs_hz = 105.0;
+    if (cfg_.frames_per_packet == 0) cfg_.frames_per_packet = 1;
+    if (cfg_.wire != WireFormat::Binary) cfg_.wire = WireFormat::Csv;
+
+    sensors_ = BruteForce_16x2Solver::sensor_positions();
+    rng_.seed(cfg_.seed);
+    gauss_.reset();
+    uni_.reset();
+
+    k_ = 0;
+    dropped_ = 0;
+    for (int j = 0; j < NSENS; ++j) {
+        u_prev_[j] = v_prev_[j] = drift_[j] = 0.0;
+        hum_phase_[j] = 2.0 * kPi * uni_(rng_);
+    }
+}
+
+Vec3d SensorArraySimulator::position(double t_s) const {
+    const double w = 2.0 * kPi * cfg_.path_hz;
+    return {
+        cfg_.path_x_m * std::sin(w * t_s),
+        cfg_.path_y_m * std::sin(1.3 * w * t_s + 0.5 * kPi),
+        cfg_.path_z_m + cfg_.path_dz_m * std::sin(0.7 * w * t_s),
+    };
+}
+
+void SensorArraySimulator::frame(float* x) {
+    const double dt = 1.0 / cfg_.fs_hz;
+    const double t = (double)k_ * dt;
+    const Vec3d r = position(t);
+
+    // Trapezoidal first-order high-pass, as the solver models it with RC in
+    // samples: (v1 + v2) / (2 RC) + (v2 - v1) = u2 - u1.
+    const double h = cfg_.rc_samples > 0.0 ? 1.0 / (2.0 * cfg_.rc_samples) : 0.0;
+    const double drift_step = cfg_.drift_rms * std::sqrt(dt);
+
+    for (int j = 0; j < NSENS; ++j) {
+        double dx = r.x - sensors_[j].x;
+        double dy = r.y - sensors_[j].y;
+        double dz = r.z - sensors_[j].z;
+        double d = std::sqrt(dx * dx + dy * dy + dz * dz);
+        double u = cfg_.charge / (d < 1e-6 ? 1e-6 : d);
+
+        double v = u;
+        if (cfg_.rc_samples > 0.0) {
+            v = (v_prev_[j] * (1.0 - h) + (u - u_prev_[j])) / (1.0 + h);
+        }
+        u_prev_[j] = u;
+        v_prev_[j] = v;
+
+        drift_[j] += drift_step * gauss_(rng_);
+        double hum = cfg_.hum_amp * std::sin(2.0 * kPi * cfg_.hum_hz * t + hum_phase_[j]);
+
+        x[j] = (float)(v + hum + drift_[j] + cfg_.noise_rms * gauss_(rng_));
+    }
+
+    ++k_;
+}
+
+size_t SensorArraySimulator::next_packet(std::string& out) {
+    const size_t nf = cfg_.frames_per_packet;
+    if (rows_.size() < nf * NSENS) rows_.resize(nf * NSENS);
+
+    const uint64_t k0 = k_;
+    for (size_t i = 0; i < nf; ++i) frame(rows_.data() + i * NSENS);
+
+    // The signal keeps evolving while a packet is lost; only the bytes go.
+    if (cfg_.loss > 0.0 && uni_(rng_) < cfg_.loss) {
+        dropped_ += nf;
+        return nf;
+    }
+
+    char buf[32];
+    for (size_t i = 0; i < nf; ++i) {
+        const uint64_t k = k0 + i;
+        const float* x = rows_.data() + i * NSENS;
+
+        if (cfg_.wire == WireFormat::Binary) {
+            BinaryFrameDecoder::encode_frame((uint16_t)(k & 0xFFFF), BinaryEncoding::Float32, x, NSENS, out);
+            continue;
+        }
+
+        // Device time in micros(), wrapping at 32 bits like an MCU counter.
+        uint32_t t_us = (uint32_t)(uint64_t)std::llround((double)k * 1e6 / cfg_.fs_hz);
+        int m = std::snprintf(buf, sizeof(buf), "%u,%u", (unsigned)(k & 0xFFFF), (unsigned)t_us);
+        out.append(buf, (size_t)m);
+        for (int j = 0; j < NSENS; ++j) {
+            m = std::snprintf(buf, sizeof(buf), ",%.6g", (double)x[j]);
+            out.append(buf, (size_t)m);
+        }
+        out.push_back('\n');
+    }
+    return nf;
+}
+
+SimulatorReader::~SimulatorReader() {
+    close();
+}
+
+void SimulatorReader::start(const SimConfig& cfg, double speed, SpscByteRing& ring, DataFn on_data) {
+    close();
+
+    sim_.reset(cfg);
+    speed_ = speed;
+    ring_ = &ring;
+    on_data_ = std::move(on_data);
+    frames_.store(0);
+    dropped_.store(0);
+
+    run_.store(true);
+    thread_ = std::thread([this]() { this->run(); });
+}
+
+void SimulatorReader::flush(std::string& out) {
+    size_t off = 0;
+    while (off < out.size()) {
+        char* p = nullptr;
+        size_t span = ring_->write_span(p);
+        if (span == 0) {
+            // Paced: a device would drop. Unpaced: wait for the consumer.
+            if (speed_ > 0.0) {
+                ring_->note_overflow(out.size() - off);
+                break;
+            }
+            if (!run_.load()) break;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+
+        size_t n = std::min(span, out.size() - off);
+        std::memcpy(p, out.data() + off, n);
+        ring_->commit(n);
+        off += n;
+        if (on_data_) on_data_();
+    }
+    out.clear();
+}
+
+void SimulatorReader::run() {
+    std::string out;
+    const uint64_t start_ns = now_ns();
+
+    while (run_.load()) {
+        if (speed_ > 0.0) {
+            // A packet leaves once its last frame has been sampled.
+            const SimConfig& c = sim_.config();
+            double t_last = (double)(sim_.frames() + c.frames_per_packet) / c.fs_hz;
+            uint64_t due = start_ns + (uint64_t)std::llround(t_last / speed_ * 1e9);
+            uint64_t now = now_ns();
+            if (now < due) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(std::min<uint64_t>(due - now, 10000000ULL)));
+                continue;
+            }
+            sim_.next_packet(out);
+        } else {
+            // Bounded so that a stream losing every packet still checks run_.
+            for (int i = 0; i < 256 && out.size() < 4096; ++i) sim_.next_packet(out);
+        }
+
+        frames_.store(sim_.frames(), std::memory_order_relaxed);
+        dropped_.store(sim_.dropped_frames(), std::memory_order_relaxed);
+        flush(out);
+    }
+}
+
+void SimulatorReader::close() {
+    run_.store(false);
+    if (thread_.joinable()) thread_.join();
+}
+
+}
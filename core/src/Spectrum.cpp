@@ -0,0 +1,127 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+#include "hub/Spectrum.h"
+
+namespace hub {
+
+static double window_at(SpectrumWindow w, size_t i, size_t n) {
+    // Periodic windows: the segments tile with hop = n/2 (Hann) or n/4.
+    const double a = 2.0 * M_PI * (double)i / (double)n;
+    switch (w) {
+    case SpectrumWindow::Hann: return 0.5 - 0.5 * std::cos(a);
+    case SpectrumWindow::Hamming: return 0.54 - 0.46 * std::cos(a);
+    case SpectrumWindow::Blackman: return 0.42 - 0.5 * std::cos(a) + 0.08 * std::cos(2.0 * a);
+    case SpectrumWindow::Rect: break;
+    }
+    return 1.0;
+}
+
+void SpectrumAnalyzer::configure(size_t n_ch, const SpectrumConfig& cfg) {
+    cfg_ = cfg;
+    if (cfg_.fft_size < 8) cfg_.fft_size = 8;
+    if (!Fft::is_pow2(cfg_.fft_size)) cfg_.fft_size = Fft::next_pow2(cfg_.fft_size);
+    cfg_.hop = std::min(std::max<size_t>(cfg_.hop, 1), cfg_.fft_size);
+    cfg_.average = std::max<size_t>(cfg_.average, 1);
+    if (!(cfg_.fs_hz > 0.0)) cfg_.fs_hz = 200.0;
+
+    n_ch_ = n_ch;
+    const size_t n = cfg_.fft_size;
+    fft_.resize(n);
+
+    win_.resize(n);
+    double ss = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        win_[i] = window_at(cfg_.window, i, n);
+        ss += win_[i] * win_[i];
+    }
+    scale_ = 1.0 / (cfg_.fs_hz * ss);
+
+    seg_.resize(n);
+    spec_.resize(fft_.bins());
+    ring_.assign(n_ch_ * n, 0.0f);
+    hist_.assign(cfg_.average * n_ch_ * fft_.bins(), 0.0f);
+    last_.assign(n_ch_ * fft_.bins(), 0.0f);
+    reset();
+}
+
+void SpectrumAnalyzer::reset() {
+    pos_ = 0;
+    fill_ = 0;
+    since_ = 0;
+    hist_pos_ = 0;
+    hist_fill_ = 0;
+    segments_ = 0;
+    std::fill(last_.begin(), last_.end(), 0.0f);
+}
+
+size_t SpectrumAnalyzer::push(const FrameBlock& blk) {
+    if (blk.n_ch != n_ch_ || n_ch_ == 0) return 0;
+
+    const size_t n = cfg_.fft_size;
+    size_t done = 0;
+    for (size_t i = 0; i < blk.n_frames; ++i) {
+        const float* x = blk.row(i);
+        for (size_t c = 0; c < n_ch_; ++c) ring_[c * n + pos_] = x[c];
+        pos_ = pos_ + 1 == n ? 0 : pos_ + 1;
+        if (fill_ < n) ++fill_;
+
+        if (++since_ >= cfg_.hop && fill_ == n) {
+            since_ = 0;
+            segment();
+            ++done;
+        }
+    }
+    return done;
+}
+
+void SpectrumAnalyzer::segment() {
+    const size_t n = cfg_.fft_size;
+    const size_t nb = fft_.bins();
+    float* hist = hist_.data() + hist_pos_ * n_ch_ * nb;
+
+    for (size_t c = 0; c < n_ch_; ++c) {
+        // Oldest row first: pos_ .. n-1, then 0 .. pos_-1.
+        const float* r = ring_.data() + c * n;
+        const size_t tail = n - pos_;
+        for (size_t i = 0; i < tail; ++i) seg_[i] = (double)r[pos_ + i];
+        for (size_t i = 0; i < pos_; ++i) seg_[tail + i] = (double)r[i];
+
+        double mean = 0.0;
+        if (cfg_.detrend) {
+            for (size_t i = 0; i < n; ++i) mean += seg_[i];
+            mean /= (double)n;
+        }
+        for (size_t i = 0; i < n; ++i) seg_[i] = (seg_[i] - mean) * win_[i];
+
+        fft_.forward(seg_.data(), spec_.data());
+
+        // One-sided: every bin but DC and Nyquist also carries its mirror.
+        float* out = last_.data() + c * nb;
+        for (size_t k = 0; k < nb; ++k) {
+            const double p = std::norm(spec_[k]) * scale_;
+            out[k] = (float)(k == 0 || k == nb - 1 ? p : 2.0 * p);
+        }
+        std::copy(out, out + nb, hist + c * nb);
+    }
+
+    hist_pos_ = hist_pos_ + 1 == cfg_.average ? 0 : hist_pos_ + 1;
+    if (hist_fill_ < cfg_.average) ++hist_fill_;
+    ++segments_;
+}
+
+void SpectrumAnalyzer::welch(std::vector<float>& out) const {
+    const size_t m = n_ch_ * fft_.bins();
+    out.assign(m, 0.0f);
+    if (hist_fill_ == 0) return;
+
+    std::vector<double> acc(m, 0.0);
+    for (size_t h = 0; h < hist_fill_; ++h) {
+        const float* p = hist_.data() + h * m;
+        for (size_t i = 0; i < m; ++i) acc[i] += (double)p[i];
+    }
+    const double s = 1.0 / (double)hist_fill_;
+    for (size_t i = 0; i < m; ++i) out[i] = (float)(acc[i] * s);
+}
+
+}
@@ -0,0 +1,102 @@
+#include "hub/SpscRing.h"
+#include <cstring>
+
+namespace hub {
+
+SpscByteRing::SpscByteRing(size_t capacity) {
+    size_t cap = 64;
+    while (cap < capacity) cap <<= 1;
+    buf_.assign(cap, 0);
+    mask_ = cap - 1;
+}
+
+void SpscByteRing::reset() {
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    overflow_events_.store(0, std::memory_order_relaxed);
+    overflow_bytes_.store(0, std::memory_order_relaxed);
+    high_water_.store(0, std::memory_order_relaxed);
+}
+
+size_t SpscByteRing::size() const {
+    size_t h = head_.load(std::memory_order_acquire);
+    size_t t = tail_.load(std::memory_order_acquire);
+    return h - t;
+}
+
+void SpscByteRing::update_high_water(size_t used) {
+    // Only the producer writes high_water_, so a plain compare is enough.
+    if (used > high_water_.load(std::memory_order_relaxed)) {
+        high_water_.store(used, std::memory_order_relaxed);
+    }
+}
+
+void SpscByteRing::note_overflow(size_t n) {
+    overflow_events_.fetch_add(1, std::memory_order_relaxed);
+    overflow_bytes_.fetch_add(n, std::memory_order_relaxed);
+}
+
+bool SpscByteRing::write(const void* data, size_t n) {
+    if (n == 0) return true;
+
+    size_t h = head_.load(std::memory_order_relaxed);
+    size_t t = tail_.load(std::memory_order_acquire);
+    size_t cap = buf_.size();
+
+    if (n > cap - (h - t)) {
+        note_overflow(n);
+        return false;
+    }
+
+    const char* src = static_cast<const char*>(data);
+    size_t off = h & mask_;
+    size_t first = cap - off;
+    if (first > n) first = n;
+
+    std::memcpy(buf_.data() + off, src, first);
+    if (n > first) std::memcpy(buf_.data(), src + first, n - first);
+
+    head_.store(h + n, std::memory_order_release);
+    update_high_water(h + n - t);
+    return true;
+}
+
+size_t SpscByteRing::write_span(char*& p) {
+    size_t h = head_.load(std::memory_order_relaxed);
+    size_t t = tail_.load(std::memory_order_acquire);
+    size_t cap = buf_.size();
+
+    size_t free = cap - (h - t);
+    size_t off = h & mask_;
+    size_t contig = cap - off;
+
+    p = buf_.data() + off;
+    return free < contig ? free : contig;
+}
+
+void SpscByteRing::commit(size_t n) {
+    if (n == 0) return;
+    size_t h = head_.load(std::memory_order_relaxed);
+    size_t t = tail_.load(std::memory_order_acquire);
+    head_.store(h + n, std::memory_order_release);
+    update_high_water(h + n - t);
+}
+
+size_t SpscByteRing::read_span(const char*& p) const {
+    size_t t = tail_.load(std::memory_order_relaxed);
+    size_t h = head_.load(std::memory_order_acquire);
+
+    size_t avail = h - t;
+    size_t off = t & mask_;
+    size_t contig = buf_.size() - off;
+
+    p = buf_.data() + off;
+    return avail < contig ? avail : contig;
+}
+
+void SpscByteRing::consume(size_t n) {
+    size_t t = tail_.load(std::memory_order_relaxed);
+    tail_.store(t + n, std::memory_order_release);
+}
+
+}
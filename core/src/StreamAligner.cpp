@@ -0,0 +1,141 @@
+#include "hub/StreamAligner.h"
+#include <algorithm>
+
+namespace hub {
+
+// Frames buffered per source before the oldest are dropped (reference stalled).
+static constexpr size_t kMaxQueue = 8192;
+
+void StreamAligner::reset() {
+    src_.clear();
+    newest_ns_ = 0;
+}
+
+size_t StreamAligner::add_source() {
+    for (size_t i = 0; i < src_.size(); ++i) {
+        if (!src_[i].active) {
+            src_[i] = Source{};
+            src_[i].active = true;
+            return i;
+        }
+    }
+    src_.emplace_back();
+    src_.back().active = true;
+    return src_.size() - 1;
+}
+
+void StreamAligner::remove_source(size_t id) {
+    if (id >= src_.size()) return;
+    src_[id] = Source{};
+}
+
+size_t StreamAligner::active_sources() const {
+    size_t n = 0;
+    for (const auto& s : src_) n += s.active ? 1 : 0;
+    return n;
+}
+
+int StreamAligner::reference() const {
+    for (size_t i = 0; i < src_.size(); ++i) {
+        if (src_[i].active) return (int)i;
+    }
+    return -1;
+}
+
+size_t StreamAligner::offset_of(size_t id) const {
+    size_t off = 0;
+    for (size_t i = 0; i < id && i < src_.size(); ++i) {
+        if (src_[i].active) off += src_[i].n_ch;
+    }
+    return off;
+}
+
+size_t StreamAligner::n_ch() const {
+    return offset_of(src_.size());
+}
+
+void StreamAligner::push(size_t id, uint64_t t_ns, const float* x, size_t n) {
+    if (id >= src_.size() || n == 0) return;
+    Source& s = src_[id];
+    if (!s.active) return;
+
+    if (s.n_ch == 0) s.n_ch = n;
+    if (n != s.n_ch) return;
+
+    // Interpolation needs monotonic time per source.
+    if (!s.q.empty() && t_ns <= s.q.back().t_ns) return;
+    if (s.q.empty() && s.has_last && t_ns <= s.last.t_ns) return;
+
+    if (s.q.size() >= kMaxQueue) s.q.pop_front();
+
+    Frame f;
+    f.t_ns = t_ns;
+    f.x.assign(x, x + n);
+    s.q.push_back(std::move(f));
+
+    if (t_ns > newest_ns_) newest_ns_ = t_ns;
+}
+
+void StreamAligner::sample_at(Source& s, uint64_t t, float* out) {
+    // Advance so that last.t <= t < q.front().t.
+    while (!s.q.empty() && s.q.front().t_ns <= t) {
+        s.last = std::move(s.q.front());
+        s.has_last = true;
+        s.q.pop_front();
+    }
+
+    if (s.has_last && !s.q.empty()) {
+        const Frame& a = s.last;
+        const Frame& b = s.q.front();
+        float w = (float)((double)(t - a.t_ns) / (double)(b.t_ns - a.t_ns));
+        for (size_t c = 0; c < s.n_ch; ++c) out[c] = a.x[c] + w * (b.x[c] - a.x[c]);
+    } else if (s.has_last) {
+        std::copy(s.last.x.begin(), s.last.x.end(), out);      // stalled: hold
+    } else if (!s.q.empty()) {
+        std::copy(s.q.front().x.begin(), s.q.front().x.end(), out); // starts later
+    } else {
+        std::fill(out, out + s.n_ch, 0.0f);
+    }
+}
+
+bool StreamAligner::pop(Frame& out) {
+    int r = reference();
+    if (r < 0) return false;
+
+    Source& ref = src_[(size_t)r];
+    if (ref.q.empty()) return false;
+
+    const uint64_t t = ref.q.front().t_ns;
+    const bool stale = newest_ns_ > t && (newest_ns_ - t) > max_wait_ns_;
+
+    if (!stale) {
+        for (size_t i = (size_t)r + 1; i < src_.size(); ++i) {
+            const Source& s = src_[i];
+            if (!s.active || s.n_ch == 0) continue;
+            if (s.q.empty() || s.q.back().t_ns < t) return false;
+        }
+    }
+
+    out.t_ns = t;
+    out.x.resize(n_ch());
+
+    float* dst = out.x.data();
+    for (size_t i = (size_t)r; i < src_.size(); ++i) {
+        Source& s = src_[i];
+        if (!s.active || s.n_ch == 0) continue;
+
+        if (i == (size_t)r) {
+            std::copy(s.q.front().x.begin(), s.q.front().x.end(), dst);
+            s.last = std::move(s.q.front());
+            s.has_last = true;
+            s.q.pop_front();
+        } else {
+            sample_at(s, t, dst);
+        }
+        dst += s.n_ch;
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,82 @@
+#include "hub/StreamDecoder.h"
+
+namespace hub {
+
+// Bytes without a decision before the stream is treated as CSV.
+static constexpr size_t kDetectLimit = 1024;
+
+void StreamDecoder::reset() {
+    wire_ = WireFormat::Unknown;
+    wire_event_ = false;
+    synced_ = false;
+    detect_buf_.clear();
+
+    bin_.clear();
+    framer_.clear();
+    parser_.set_layout(layout_);
+
+    timeline_.reset();
+    clock_.reset();
+    dev_time_ = false;
+}
+
+bool StreamDecoder::take_wire_detected() {
+    bool e = wire_event_;
+    wire_event_ = false;
+    return e;
+}
+
+double StreamDecoder::rate_hz() const {
+    if (dev_time_) return timeline_.period_s() > 0.0 ? 1.0 / timeline_.period_s() : 0.0;
+    return clock_.rate_hz();
+}
+
+size_t StreamDecoder::decode(std::string_view chunk, uint64_t t_ns, FrameBlock& blk) {
+    blk.clear();
+
+    // Decide between CSV text and the binary protocol from the first bytes.
+    if (wire_ == WireFormat::Unknown) {
+        detect_buf_.append(chunk.data(), chunk.size());
+        wire_ = detect_wire_format(detect_buf_);
+        if (wire_ == WireFormat::Unknown) {
+            if (detect_buf_.size() < kDetectLimit) return 0;
+            wire_ = WireFormat::Csv;
+        }
+        wire_event_ = true;
+        chunk = std::string_view(detect_buf_);
+    }
+
+    // A partial first line would fix the channel count wrongly (e.g. 10
+    // instead of 16) and every later line would be rejected.
+    if (wire_ == WireFormat::Csv && line_sync_ && !synced_) {
+        size_t i = chunk.find_first_of("\r\n");
+        if (i == std::string_view::npos) {
+            detect_buf_.clear();
+            return 0;
+        }
+        size_t adv = (chunk[i] == '\r' && i + 1 < chunk.size() && chunk[i + 1] == '\n') ? 2 : 1;
+        chunk.remove_prefix(i + adv);
+        synced_ = true;
+    }
+
+    size_t nbad = 0;
+    if (wire_ == WireFormat::Binary) {
+        nbad = bin_.decode_block(chunk, t_ns, blk);
+    } else {
+        framer_.feed(chunk);
+        nbad = parser_.parse_block(framer_, t_ns, blk);
+    }
+
+    // detect_buf_ has been consumed (the framer keeps its own copy of a partial line).
+    if (!detect_buf_.empty()) detect_buf_.clear();
+
+    // Device counters/time: count gaps and replace arrival stamps with device
+    // time; without device time, recover the sample clock from arrivals.
+    if (blk.has_seq || blk.has_dev_t) timeline_.apply(blk);
+    if (blk.n_frames > 0) dev_time_ = blk.has_dev_t;
+    if (!blk.has_dev_t) clock_.apply(blk);
+
+    return nbad;
+}
+
+}
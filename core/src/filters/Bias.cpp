@@ -68,8 +68,12 @@ void BiasCorrector::set_bias(const std::vector<float>& bias) {
 }
 
 void BiasCorrector::update_capture(const std::vector<float>& x) {
+    update_capture(x.data(), x.size());
+}
+
+void BiasCorrector::update_capture(const float* x, size_t n) {
     if (!capturing_) return;
-    if (x.size() != n_ch_) return;
+    if (n != n_ch_) return;
 
     if (acc_.size() != n_ch_) acc_.assign(n_ch_, 0.0);
 
@@ -87,8 +91,12 @@ void BiasCorrector::update_capture(const std::vector<float>& x) {
 }
 
 void BiasCorrector::apply_inplace(std::vector<float>& x) const {
+    apply_inplace(x.data(), x.size());
+}
+
+void BiasCorrector::apply_inplace(float* x, size_t n) const {
     if (!has_bias_) return;
-    if (x.size() != n_ch_) return;
+    if (n != n_ch_) return;
 
     for (size_t i = 0; i < n_ch_; ++i) x[i] -= bias_[i];
 }
@@ -0,0 +1,92 @@
+#include "hub/filters/Decimator.h"
+#include <algorithm>
+#include "hub/filters/Fir.h"
+
+namespace hub {
+
+void Decimator::reset() {
+    ready_ = false;
+    primed_ = false;
+    n_ch_ = 0;
+    factor_ = 1;
+    h_.clear();
+    phase_ = 0;
+    n_acc_ = 0;
+    head_ = 0;
+    acc_.clear();
+}
+
+void Decimator::configure(size_t n_ch, size_t factor, size_t taps) {
+    reset();
+    n_ch_ = n_ch;
+    factor_ = factor < 1 ? 1 : factor;
+    ready_ = true;
+    if (factor_ == 1) return;
+
+    if (taps == 0) taps = 20 * factor_ + 1;
+    h_ = design_fir(FilterBand::LowPass, taps, 1.0, 0.5 / (double)factor_);
+
+    // Output m takes inputs m*M - taps + 1 .. m*M, so an input is pending in
+    // at most (taps - 1) / M + 1 outputs.
+    n_acc_ = (h_.size() - 1) / factor_ + 1;
+    acc_.assign(n_acc_ * n_ch_, 0.0);
+}
+
+// Outputs 0 .. n_acc_ - 1 start with the part of their sum that lies before
+// the first frame, all of it equal to that frame.
+void Decimator::prime(const float* x) {
+    for (size_t m = 0; m < n_acc_; ++m) {
+        double w = 0.0;
+        for (size_t k = m * factor_ + 1; k < h_.size(); ++k) w += h_[k];
+        double* a = acc_.data() + m * n_ch_;
+        for (size_t c = 0; c < n_ch_; ++c) a[c] = w * (double)x[c];
+    }
+    head_ = 0;
+    phase_ = 0;
+    primed_ = true;
+}
+
+bool Decimator::push(const float* x, float* out) {
+    if (!ready_) return false;
+    if (factor_ == 1) {
+        if (out != x) std::copy(x, x + n_ch_, out);
+        return true;
+    }
+    if (!primed_) prime(x);
+
+    // Input t = q*M + phase_ feeds output q + j + (phase_ ? 1 : 0) with tap
+    // (q + j') * M - t for every such tap below taps.
+    const size_t L = h_.size();
+    size_t k = phase_ ? factor_ - phase_ : 0;
+    for (size_t j = 0; k < L; ++j, k += factor_) {
+        const double w = h_[k];
+        double* a = acc_.data() + ((head_ + j) % n_acc_) * n_ch_;
+        for (size_t c = 0; c < n_ch_; ++c) a[c] += w * (double)x[c];
+    }
+
+    if (phase_ != 0) {
+        if (++phase_ == factor_) phase_ = 0;
+        return false;
+    }
+
+    // Tap 0 was the last contribution to the head output.
+    double* a = acc_.data() + head_ * n_ch_;
+    for (size_t c = 0; c < n_ch_; ++c) {
+        out[c] = (float)a[c];
+        a[c] = 0.0;
+    }
+    if (++head_ == n_acc_) head_ = 0;
+    if (++phase_ == factor_) phase_ = 0;
+    return true;
+}
+
+void Decimator::process(const FrameBlock& in, FrameBlock& out) {
+    out.n_ch = in.n_ch;
+    if (in.n_ch != n_ch_) return;
+    for (size_t i = 0; i < in.n_frames; ++i) {
+        float* y = out.append(in.t_ns[i]);
+        if (!push(in.row(i), y)) out.pop_back();
+    }
+}
+
+}
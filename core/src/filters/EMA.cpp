@@ -5,6 +5,7 @@ namespace hub {
 
 void EMAFilter::reset() {
     ready_ = false;
+    primed_ = false;
     n_ch_ = 0;
     alpha_ = 0.2f;
     y_.clear();
@@ -14,6 +15,7 @@ void EMAFilter::configure(size_t n_ch, float alpha) {
     n_ch_ = n_ch;
     set_alpha(alpha);
     y_.assign(n_ch_, 0.0f);
+    primed_ = false;
     ready_ = true;
 }
 
@@ -24,8 +26,18 @@ void EMAFilter::set_alpha(float alpha) {
 }
 
 void EMAFilter::process_inplace(std::vector<float>& x) {
+    process_inplace(x.data(), x.size());
+}
+
+void EMAFilter::process_inplace(float* x, size_t n) {
     if (!ready_) return;
-    if (x.size() != n_ch_) return;
+    if (n != n_ch_) return;
+
+    if (!primed_) {
+        std::copy(x, x + n_ch_, y_.begin());
+        primed_ = true;
+        return;
+    }
 
     float a = alpha_;
     float b = 1.0f - a;
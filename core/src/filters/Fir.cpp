@@ -0,0 +1,301 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include "hub/filters/Fir.h"
+
+namespace hub {
+
+// ---- Design ------------------------------------------------------------------
+
+std::vector<double> design_fir(FilterBand band, size_t taps, double fs_hz, double f1_hz, double f2_hz) {
+    std::vector<double> h;
+    const double ny = 0.5 * fs_hz;
+    if (taps < 1 || !(fs_hz > 0.0) || !(f1_hz > 0.0) || f1_hz >= ny) return h;
+    if (band == FilterBand::BandPass && !(f2_hz > f1_hz && f2_hz < ny)) return h;
+
+    // High/band-pass need a center tap (type I).
+    if (band != FilterBand::LowPass && taps % 2 == 0) ++taps;
+
+    const double m = 0.5 * (double)(taps - 1);
+    // Ideal low-pass with cutoff fc (cycles/sample), sampled at k - m.
+    auto lowpass = [m](double fc, size_t k) {
+        const double t = (double)k - m;
+        return t == 0.0 ? 2.0 * fc : std::sin(2.0 * M_PI * fc * t) / (M_PI * t);
+    };
+
+    const double w1 = f1_hz / fs_hz;
+    const double w2 = f2_hz / fs_hz;
+    h.resize(taps);
+    for (size_t k = 0; k < taps; ++k) {
+        double v = 0.0;
+        switch (band) {
+        case FilterBand::LowPass: v = lowpass(w1, k); break;
+        case FilterBand::HighPass: v = ((double)k == m ? 1.0 : 0.0) - lowpass(w1, k); break;
+        case FilterBand::BandPass: v = lowpass(w2, k) - lowpass(w1, k); break;
+        }
+        const double win = taps > 1 ? 0.54 - 0.46 * std::cos(2.0 * M_PI * (double)k / (double)(taps - 1)) : 1.0;
+        h[k] = v * win;
+    }
+
+    // Unity gain at the reference frequency.
+    double fref = 0.0;
+    if (band == FilterBand::HighPass) fref = 0.5;
+    else if (band == FilterBand::BandPass) fref = 0.5 * (w1 + w2);
+    double re = 0.0, im = 0.0;
+    for (size_t k = 0; k < taps; ++k) {
+        re += h[k] * std::cos(2.0 * M_PI * fref * (double)k);
+        im -= h[k] * std::sin(2.0 * M_PI * fref * (double)k);
+    }
+    const double g = std::hypot(re, im);
+    if (g > 0.0) for (auto& v : h) v /= g;
+    return h;
+}
+
+bool load_fir_kernel(const std::string& path, std::vector<double>& taps, std::string& err) {
+    taps.clear();
+    std::ifstream f(path);
+    if (!f) {
+        err = "cannot open FIR kernel '" + path + "'";
+        return false;
+    }
+
+    std::string line;
+    size_t line_no = 0;
+    while (std::getline(f, line)) {
+        ++line_no;
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+        for (auto& c : line) {
+            if (c == ',' || c == ';') c = ' ';
+        }
+
+        const char* p = line.c_str();
+        for (;;) {
+            while (*p == ' ' || *p == '\t' || *p == '\r') ++p;
+            if (*p == '\0') break;
+            char* end = nullptr;
+            const double v = std::strtod(p, &end);
+            if (end == p || !std::isfinite(v)) {
+                err = "FIR kernel '" + path + "' line " + std::to_string(line_no) + ": not a number";
+                taps.clear();
+                return false;
+            }
+            taps.push_back(v);
+            p = end;
+        }
+    }
+
+    if (taps.empty()) {
+        err = "FIR kernel '" + path + "' has no coefficients";
+        return false;
+    }
+    return true;
+}
+
+double fir_group_delay(const std::vector<double>& taps) {
+    const size_t n = taps.size();
+    if (n == 0) return 0.0;
+
+    double scale = 0.0;
+    for (double v : taps) scale = std::max(scale, std::fabs(v));
+    const double tol = 1e-9 * scale;
+    bool sym = true, anti = true;
+    for (size_t k = 0; k < n / 2; ++k) {
+        const double a = taps[k], b = taps[n - 1 - k];
+        sym = sym && std::fabs(a - b) <= tol;
+        anti = anti && std::fabs(a + b) <= tol;
+    }
+    if (sym || anti) return 0.5 * (double)(n - 1);
+
+    double e = 0.0, ke = 0.0;
+    for (size_t k = 0; k < n; ++k) {
+        e += taps[k] * taps[k];
+        ke += (double)k * taps[k] * taps[k];
+    }
+    return e > 0.0 ? ke / e : 0.0;
+}
+
+// ---- Method choice -----------------------------------------------------------
+//
+// Rough cost per channel and frame, in direct-form multiply-adds: a butterfly
+// and a spectrum product cost about kButterfly and kProduct of them, and one
+// complex transform pair (forward, inverse) serves two channels per block.
+
+static constexpr double kButterfly = 2.0;
+static constexpr double kProduct = 2.0;
+static constexpr size_t kMinFftTaps = 32;
+
+static double fft_cost(size_t taps, size_t n) {
+    double bits = 0.0;
+    for (size_t m = n; m > 1; m >>= 1) bits += 1.0;
+    const double hop = (double)(n - taps + 1);
+    const double per_block = 2.0 * (0.5 * (double)n * bits) * kButterfly + (double)n * kProduct;
+    return per_block / (2.0 * hop);
+}
+
+size_t fir_fft_size(size_t taps) {
+    if (taps < kMinFftTaps) return 0;
+    // At least twice the kernel: larger transforms are a little cheaper per
+    // frame but add their block to the latency.
+    const size_t n = Fft::next_pow2(2 * taps);
+    return fft_cost(taps, n) < (double)taps ? n : 0;
+}
+
+// ---- Filter ------------------------------------------------------------------
+
+void FirFilter::reset() {
+    ready_ = false;
+    primed_ = false;
+    n_ch_ = 0;
+    h_.clear();
+    gd_ = 0.0;
+    hr_.clear();
+    hist_.clear();
+    acc_.clear();
+    pos_ = 0;
+    fft_n_ = 0;
+    hop_ = 0;
+    fill_ = 0;
+    hf_.clear();
+    in_.clear();
+    work_.clear();
+    out_.clear();
+}
+
+void FirFilter::configure(size_t n_ch, const std::vector<double>& taps, FirMethod method) {
+    reset();
+    n_ch_ = n_ch;
+    h_ = taps;
+    gd_ = fir_group_delay(h_);
+    ready_ = true;
+    if (h_.empty() || n_ch_ == 0) return;
+
+    const size_t L = h_.size();
+    size_t n = 0;
+    if (method == FirMethod::Auto) n = fir_fft_size(L);
+    else if (method == FirMethod::OverlapSave) n = Fft::next_pow2(2 * L);
+
+    if (n == 0) {
+        hr_.assign(h_.rbegin(), h_.rend());
+        hist_.assign(2 * L * n_ch_, 0.0f);
+        acc_.assign(n_ch_, 0.0);
+        return;
+    }
+
+    fft_n_ = n;
+    hop_ = n - L + 1;
+    fft_.resize(n);
+    hf_.assign(n, std::complex<double>(0.0, 0.0));
+    for (size_t k = 0; k < L; ++k) hf_[k] = h_[k];
+    fft_.forward(hf_.data());
+
+    in_.assign(((n_ch_ + 1) / 2) * n, std::complex<double>(0.0, 0.0));
+    work_.assign(n, std::complex<double>(0.0, 0.0));
+    out_.assign(hop_ * n_ch_, 0.0f);
+}
+
+void FirFilter::prime(const float* x) {
+    const size_t L = h_.size();
+    if (fft_n_ == 0) {
+        for (size_t k = 0; k < 2 * L; ++k) std::memcpy(hist_.data() + k * n_ch_, x, n_ch_ * sizeof(float));
+        pos_ = 0;
+    } else {
+        // Past input held at the first frame, and the output a settled filter
+        // gives for it until the first block is through.
+        double sum = 0.0;
+        for (double v : h_) sum += v;
+        for (size_t p = 0; p < (n_ch_ + 1) / 2; ++p) {
+            const float b = 2 * p + 1 < n_ch_ ? x[2 * p + 1] : 0.0f;
+            std::fill(in_.begin() + (long)(p * fft_n_), in_.begin() + (long)(p * fft_n_ + L - 1),
+                      std::complex<double>(x[2 * p], b));
+        }
+        for (size_t j = 0; j < hop_; ++j) {
+            for (size_t c = 0; c < n_ch_; ++c) out_[j * n_ch_ + c] = (float)(sum * (double)x[c]);
+        }
+        fill_ = 0;
+    }
+    primed_ = true;
+}
+
+void FirFilter::process_inplace(std::vector<float>& x) {
+    process_inplace(x.data(), x.size());
+}
+
+void FirFilter::process_inplace(float* x, size_t n) {
+    if (!ready_ || h_.empty()) return;
+    if (n != n_ch_) return;
+
+    if (!primed_) prime(x);
+    if (fft_n_ == 0) run_direct(x);
+    else run_fft(x);
+}
+
+void FirFilter::run_direct(float* x) {
+    const size_t L = h_.size();
+    const size_t n = n_ch_;
+    std::memcpy(hist_.data() + pos_ * n, x, n * sizeof(float));
+    std::memcpy(hist_.data() + (pos_ + L) * n, x, n * sizeof(float));
+
+    // Rows pos_ + 1 .. pos_ + L hold the last L frames, oldest first.
+    std::fill(acc_.begin(), acc_.end(), 0.0);
+    const float* row = hist_.data() + (pos_ + 1) * n;
+    double* acc = acc_.data();
+    for (size_t j = 0; j < L; ++j, row += n) {
+        const double w = hr_[j];
+        for (size_t c = 0; c < n; ++c) acc[c] += w * (double)row[c];
+    }
+    for (size_t c = 0; c < n; ++c) x[c] = (float)acc[c];
+
+    if (++pos_ >= L) pos_ = 0;
+}
+
+void FirFilter::run_fft(float* x) {
+    const size_t L = h_.size();
+    const size_t n = n_ch_;
+    for (size_t p = 0; p < (n + 1) / 2; ++p) {
+        const float b = 2 * p + 1 < n ? x[2 * p + 1] : 0.0f;
+        in_[p * fft_n_ + L - 1 + fill_] = std::complex<double>(x[2 * p], b);
+    }
+
+    // Frame t returns output t - (hop_ - 1): the rest of the previous block,
+    // then the first frame of the one just completed.
+    size_t row = fill_ + 1;
+    if (++fill_ == hop_) {
+        convolve_block();
+        fill_ = 0;
+        row = 0;
+    }
+    std::memcpy(x, out_.data() + row * n, n * sizeof(float));
+}
+
+void FirFilter::convolve_block() {
+    const size_t L = h_.size();
+    const size_t n = n_ch_;
+    for (size_t p = 0; p < (n + 1) / 2; ++p) {
+        std::complex<double>* in = in_.data() + p * fft_n_;
+        std::copy(in, in + fft_n_, work_.begin());
+        fft_.forward(work_.data());
+        for (size_t k = 0; k < fft_n_; ++k) {
+            const double ar = work_[k].real(), ai = work_[k].imag();
+            const double br = hf_[k].real(), bi = hf_[k].imag();
+            work_[k] = std::complex<double>(ar * br - ai * bi, ar * bi + ai * br);
+        }
+        fft_.inverse(work_.data());
+
+        // The kernel is real, so the real and imaginary parts stay the two
+        // channels. The first L - 1 outputs wrap around and are dropped.
+        const size_t a = 2 * p;
+        for (size_t j = 0; j < hop_; ++j) {
+            const std::complex<double> y = work_[L - 1 + j];
+            out_[j * n + a] = (float)y.real();
+            if (a + 1 < n) out_[j * n + a + 1] = (float)y.imag();
+        }
+
+        std::copy(in + hop_, in + fft_n_, in);
+    }
+}
+
+}
@@ -1,14 +1,18 @@
 #include "hub/filters/MA.h"
 #include <algorithm>
+#include <cmath>
 
 namespace hub {
 
 void MAFilter::reset() {
     ready_ = false;
+    primed_ = false;
     n_ch_ = 0;
     win_len_ = 1;
     idx_ = 0;
+    since_resync_ = 0;
     sum_.clear();
+    comp_.clear();
     ring_.clear();
 }
 
@@ -17,28 +21,66 @@ void MAFilter::configure(size_t n_ch, size_t win_len) {
     n_ch_ = n_ch;
     win_len_ = win_len;
     idx_ = 0;
-    sum_.assign(n_ch_, 0.0f);
+    since_resync_ = 0;
+    sum_.assign(n_ch_, 0.0);
+    comp_.assign(n_ch_, 0.0);
     ring_.assign(n_ch_ * win_len_, 0.0f);
+    primed_ = false;
     ready_ = true;
 }
 
+void MAFilter::prime(const float* x) {
+    for (size_t i = 0; i < n_ch_; ++i) sum_[i] = (double)win_len_ * (double)x[i];
+    for (size_t k = 0; k < win_len_; ++k) std::copy(x, x + n_ch_, ring_.begin() + k * n_ch_);
+    idx_ = 0;
+    since_resync_ = 0;
+    primed_ = true;
+}
+
+void MAFilter::window_sums(const float* ring, size_t n, size_t win, double* sum, double* comp) {
+    std::fill(sum, sum + n, 0.0);
+    std::fill(comp, comp + n, 0.0);
+    for (size_t k = 0; k < win; ++k, ring += n) {
+        for (size_t i = 0; i < n; ++i) {
+            const double v = (double)ring[i];
+            const double t = sum[i] + v;
+            comp[i] += std::fabs(sum[i]) >= std::fabs(v) ? (sum[i] - t) + v : (v - t) + sum[i];
+            sum[i] = t;
+        }
+    }
+    for (size_t i = 0; i < n; ++i) sum[i] += comp[i];
+}
+
 void MAFilter::process_inplace(std::vector<float>& x) {
+    process_inplace(x.data(), x.size());
+}
+
+void MAFilter::process_inplace(float* x, size_t n) {
     if (!ready_) return;
-    if (x.size() != n_ch_) return;
+    if (n != n_ch_) return;
 
-    float inv = 1.0f / static_cast<float>(win_len_);
-    size_t base = idx_ * n_ch_;
+    if (!primed_) {
+        prime(x);
+        return;
+    }
+
+    // Double sums: a float running sum drifts away from the window content.
+    const double win = (double)win_len_;
+    float* slot = ring_.data() + idx_ * n_ch_;
 
     for (size_t i = 0; i < n_ch_; ++i) {
-        float oldv = ring_[base + i];
-        float newv = x[i];
-        sum_[i] += (newv - oldv);
-        ring_[base + i] = newv;
-        x[i] = sum_[i] * inv;
+        float oldv = slot[i];
+        slot[i] = x[i];
+        sum_[i] += (double)x[i] - (double)oldv;
+        x[i] = (float)(sum_[i] / win);
     }
 
     idx_++;
     if (idx_ >= win_len_) idx_ = 0;
+    if (++since_resync_ >= resync_interval(win_len_)) {
+        since_resync_ = 0;
+        window_sums(ring_.data(), n_ch_, win_len_, sum_.data(), comp_.data());
+    }
 }
 
 }
@@ -0,0 +1,208 @@
+#include "hub/filters/Median.h"
+#include <algorithm>
+#include <cmath>
+
+namespace hub {
+
+// ---- RunningMedian -----------------------------------------------------------
+
+void RunningMedian::configure(size_t n_ch, size_t win) {
+    if (win < 1) win = 1;
+    n_ch_ = n_ch;
+    win_ = win;
+    n_lo_ = (win + 1) / 2;
+    idx_ = 0;
+    val_.assign(n_ch_ * win_, 0.0f);
+    heap_.resize(n_ch_ * win_);
+    pos_.resize(n_ch_ * win_);
+    for (size_t c = 0; c < n_ch_; ++c) {
+        for (size_t k = 0; k < win_; ++k) {
+            heap_[c * win_ + k] = k;
+            pos_[c * win_ + k] = k;
+        }
+    }
+}
+
+void RunningMedian::fill(const float* x) {
+    // Equal values satisfy both heaps in any arrangement.
+    for (size_t c = 0; c < n_ch_; ++c) std::fill(val_.begin() + (long)(c * win_), val_.begin() + (long)((c + 1) * win_), x[c]);
+    idx_ = 0;
+}
+
+// Heap nodes of channel base b: lower half at b + [0, n_lo_) as a max-heap,
+// upper half at b + n_lo_ + [0, win_ - n_lo_) as a min-heap.
+
+void RunningMedian::swap_nodes(size_t b, size_t i, size_t j) {
+    std::swap(heap_[b + i], heap_[b + j]);
+    pos_[b + heap_[b + i]] = i;
+    pos_[b + heap_[b + j]] = j;
+}
+
+void RunningMedian::sift_up_lo(size_t b, size_t i) {
+    const float* v = val_.data() + b;
+    while (i > 0) {
+        const size_t p = (i - 1) / 2;
+        if (!(v[heap_[b + i]] > v[heap_[b + p]])) break;
+        swap_nodes(b, i, p);
+        i = p;
+    }
+}
+
+void RunningMedian::sift_down_lo(size_t b, size_t i) {
+    const float* v = val_.data() + b;
+    for (;;) {
+        size_t m = i;
+        const size_t l = 2 * i + 1;
+        const size_t r = l + 1;
+        if (l < n_lo_ && v[heap_[b + l]] > v[heap_[b + m]]) m = l;
+        if (r < n_lo_ && v[heap_[b + r]] > v[heap_[b + m]]) m = r;
+        if (m == i) break;
+        swap_nodes(b, i, m);
+        i = m;
+    }
+}
+
+void RunningMedian::sift_up_hi(size_t b, size_t i) {
+    const float* v = val_.data() + b;
+    const size_t o = n_lo_;
+    while (i > 0) {
+        const size_t p = (i - 1) / 2;
+        if (!(v[heap_[b + o + i]] < v[heap_[b + o + p]])) break;
+        swap_nodes(b, o + i, o + p);
+        i = p;
+    }
+}
+
+void RunningMedian::sift_down_hi(size_t b, size_t i) {
+    const float* v = val_.data() + b;
+    const size_t o = n_lo_;
+    const size_t n_hi = win_ - n_lo_;
+    for (;;) {
+        size_t m = i;
+        const size_t l = 2 * i + 1;
+        const size_t r = l + 1;
+        if (l < n_hi && v[heap_[b + o + l]] < v[heap_[b + o + m]]) m = l;
+        if (r < n_hi && v[heap_[b + o + r]] < v[heap_[b + o + m]]) m = r;
+        if (m == i) break;
+        swap_nodes(b, o + i, o + m);
+        i = m;
+    }
+}
+
+void RunningMedian::push(const float* x, float* med) {
+    const size_t o = n_lo_;
+    const bool has_hi = win_ > n_lo_;
+
+    for (size_t c = 0; c < n_ch_; ++c) {
+        const size_t b = c * win_;
+        float* v = val_.data() + b;
+        const float old = v[idx_];
+        const float nv = x[c];
+        v[idx_] = nv;
+
+        // Restore the heap the slot sits in, then move a value across if it
+        // now belongs to the other half.
+        const size_t j = pos_[b + idx_];
+        if (j < o) {
+            if (nv > old) sift_up_lo(b, j);
+            else sift_down_lo(b, j);
+        } else {
+            if (nv < old) sift_up_hi(b, j - o);
+            else sift_down_hi(b, j - o);
+        }
+        if (has_hi && v[heap_[b]] > v[heap_[b + o]]) {
+            swap_nodes(b, 0, o);
+            sift_down_lo(b, 0);
+            sift_down_hi(b, 0);
+        }
+
+        const float lo = v[heap_[b]];
+        med[c] = has_hi && (win_ % 2) == 0 ? 0.5f * (lo + v[heap_[b + o]]) : lo;
+    }
+
+    if (++idx_ >= win_) idx_ = 0;
+}
+
+// ---- MedianFilter ------------------------------------------------------------
+
+void MedianFilter::reset() {
+    ready_ = false;
+    primed_ = false;
+    n_ch_ = 0;
+}
+
+void MedianFilter::configure(size_t n_ch, size_t win_len) {
+    n_ch_ = n_ch;
+    med_.configure(n_ch, win_len);
+    primed_ = false;
+    ready_ = true;
+}
+
+void MedianFilter::process_inplace(std::vector<float>& x) {
+    process_inplace(x.data(), x.size());
+}
+
+void MedianFilter::process_inplace(float* x, size_t n) {
+    if (!ready_) return;
+    if (n != n_ch_) return;
+
+    if (!primed_) {
+        med_.fill(x);
+        primed_ = true;
+    }
+    med_.push(x, x);
+}
+
+// ---- HampelFilter ------------------------------------------------------------
+
+// MAD to standard deviation for normal data.
+static constexpr float kMadScale = 1.4826f;
+
+void HampelFilter::reset() {
+    ready_ = false;
+    primed_ = false;
+    n_ch_ = 0;
+    m_.clear();
+    d_.clear();
+    s_.clear();
+}
+
+void HampelFilter::configure(size_t n_ch, size_t win_len, float k) {
+    n_ch_ = n_ch;
+    k_ = k;
+    med_.configure(n_ch, win_len);
+    mad_.configure(n_ch, win_len);
+    m_.assign(n_ch, 0.0f);
+    d_.assign(n_ch, 0.0f);
+    s_.assign(n_ch, 0.0f);
+    primed_ = false;
+    ready_ = true;
+}
+
+void HampelFilter::process_inplace(std::vector<float>& x) {
+    process_inplace(x.data(), x.size());
+}
+
+void HampelFilter::process_inplace(float* x, size_t n) {
+    if (!ready_) return;
+    if (n != n_ch_) return;
+
+    if (!primed_) {
+        med_.fill(x);
+        std::fill(d_.begin(), d_.end(), 0.0f);
+        mad_.fill(d_.data());
+        std::fill(s_.begin(), s_.end(), 0.0f);
+        primed_ = true;
+    }
+
+    med_.push(x, m_.data());
+    for (size_t c = 0; c < n_ch_; ++c) d_[c] = std::fabs(x[c] - m_[c]);
+
+    // The test uses the scale before this frame's deviation joins it.
+    for (size_t c = 0; c < n_ch_; ++c) {
+        if (d_[c] > k_ * kMadScale * s_[c]) x[c] = m_[c];
+    }
+    mad_.push(d_.data(), s_.data());
+}
+
+}
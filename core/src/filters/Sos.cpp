@@ -0,0 +1,278 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+#include <complex>
+#include "hub/filters/Sos.h"
+
+namespace hub {
+
+using cplx = std::complex<double>;
+
+// ---- Design ------------------------------------------------------------------
+//
+// Analog low-pass prototype (zeros, poles, gain) -> band transform -> bilinear
+// transform -> second-order sections. Same steps and gain bookkeeping as the
+// usual zpk design routines.
+
+struct Zpk {
+    std::vector<cplx> z;
+    std::vector<cplx> p;
+    double k = 1.0;
+};
+
+static Zpk prototype(int order, double ripple_db) {
+    Zpk f;
+    if (ripple_db <= 0.0) {
+        for (int m = -order + 1; m < order; m += 2) {
+            f.p.push_back(-std::exp(cplx(0.0, M_PI * m / (2.0 * order))));
+        }
+        return f;
+    }
+
+    const double eps = std::sqrt(std::pow(10.0, 0.1 * ripple_db) - 1.0);
+    const double mu = std::asinh(1.0 / eps) / order;
+    cplx prod = 1.0;
+    for (int m = -order + 1; m < order; m += 2) {
+        cplx p = -std::sinh(cplx(mu, M_PI * m / (2.0 * order)));
+        f.p.push_back(p);
+        prod *= -p;
+    }
+    f.k = prod.real();
+    if (order % 2 == 0) f.k /= std::sqrt(1.0 + eps * eps);
+    return f;
+}
+
+static void to_lowpass(Zpk& f, double wo) {
+    for (auto& z : f.z) z *= wo;
+    for (auto& p : f.p) p *= wo;
+    f.k *= std::pow(wo, (double)(f.p.size() - f.z.size()));
+}
+
+static void to_highpass(Zpk& f, double wo) {
+    cplx num = 1.0, den = 1.0;
+    for (auto& z : f.z) { num *= -z; z = wo / z; }
+    for (auto& p : f.p) { den *= -p; p = wo / p; }
+    const size_t degree = f.p.size() - f.z.size();
+    f.z.insert(f.z.end(), degree, cplx(0.0));
+    f.k *= (num / den).real();
+}
+
+static void to_bandpass(Zpk& f, double wo, double bw) {
+    const size_t degree = f.p.size() - f.z.size();
+    auto split = [&](std::vector<cplx>& v) {
+        std::vector<cplx> out;
+        for (auto r : v) {
+            cplx c = r * (bw / 2.0);
+            cplx d = std::sqrt(c * c - wo * wo);
+            out.push_back(c + d);
+            out.push_back(c - d);
+        }
+        v = std::move(out);
+    };
+    split(f.z);
+    split(f.p);
+    f.z.insert(f.z.end(), degree, cplx(0.0));
+    f.k *= std::pow(bw, (double)degree);
+}
+
+static void bilinear(Zpk& f, double fs) {
+    const double fs2 = 2.0 * fs;
+    cplx num = 1.0, den = 1.0;
+    for (auto& z : f.z) { num *= fs2 - z; z = (fs2 + z) / (fs2 - z); }
+    for (auto& p : f.p) { den *= fs2 - p; p = (fs2 + p) / (fs2 - p); }
+    const size_t degree = f.p.size() - f.z.size();
+    f.z.insert(f.z.end(), degree, cplx(-1.0));
+    f.k *= (num / den).real();
+}
+
+// All zeros of these designs are real (+1 / -1); poles come in conjugate pairs
+// plus real ones.
+static std::vector<Biquad> to_sections(const Zpk& f) {
+    constexpr double kTol = 1e-10;
+
+    struct Group {
+        cplx p1, p2;
+        int np;
+    };
+    std::vector<Group> groups;
+    std::vector<double> reals;
+    for (const auto& p : f.p) {
+        if (std::abs(p.imag()) <= kTol * std::max(1.0, std::abs(p))) reals.push_back(p.real());
+        else if (p.imag() > 0) groups.push_back({p, std::conj(p), 2});
+    }
+    std::sort(reals.begin(), reals.end());
+    for (size_t i = 0; i < reals.size(); i += 2) {
+        if (i + 1 < reals.size()) groups.push_back({reals[i], reals[i + 1], 2});
+        else groups.push_back({reals[i], 0.0, 1});
+    }
+    std::sort(groups.begin(), groups.end(), [](const Group& a, const Group& b) {
+        return std::max(std::abs(a.p1), std::abs(a.p2)) < std::max(std::abs(b.p1), std::abs(b.p2));
+    });
+
+    // Alternate +1 / -1 zeros so band-pass sections each get one of both.
+    std::vector<double> pos, neg;
+    for (const auto& z : f.z) (z.real() >= 0.0 ? pos : neg).push_back(z.real());
+    std::vector<double> zeros;
+    for (size_t i = 0; i < std::max(pos.size(), neg.size()); ++i) {
+        if (i < pos.size()) zeros.push_back(pos[i]);
+        if (i < neg.size()) zeros.push_back(neg[i]);
+    }
+
+    std::vector<Biquad> out;
+    size_t zi = 0;
+    for (const auto& g : groups) {
+        Biquad q;
+        if (g.np == 2) {
+            q.a1 = -(g.p1 + g.p2).real();
+            q.a2 = (g.p1 * g.p2).real();
+        } else {
+            q.a1 = -g.p1.real();
+        }
+        double z1 = zi < zeros.size() ? zeros[zi++] : 0.0;
+        if (g.np == 2) {
+            double z2 = zi < zeros.size() ? zeros[zi++] : 0.0;
+            q.b1 = -(z1 + z2);
+            q.b2 = z1 * z2;
+        } else {
+            q.b1 = -z1;
+        }
+        out.push_back(q);
+    }
+
+    if (!out.empty()) {
+        out[0].b0 *= f.k;
+        out[0].b1 *= f.k;
+        out[0].b2 *= f.k;
+    }
+    return out;
+}
+
+std::vector<Biquad> design_iir(FilterBand band, int order, double fs_hz,
+                               double f1_hz, double f2_hz, double ripple_db) {
+    if (order < 1 || fs_hz <= 0.0) return {};
+    const double nyq = 0.5 * fs_hz;
+    if (f1_hz <= 0.0 || f1_hz >= nyq) return {};
+    if (band == FilterBand::BandPass && (f2_hz <= f1_hz || f2_hz >= nyq)) return {};
+
+    auto warp = [&](double f) { return 2.0 * fs_hz * std::tan(M_PI * f / fs_hz); };
+
+    Zpk f = prototype(order, ripple_db);
+    switch (band) {
+    case FilterBand::LowPass: to_lowpass(f, warp(f1_hz)); break;
+    case FilterBand::HighPass: to_highpass(f, warp(f1_hz)); break;
+    case FilterBand::BandPass: {
+        double w1 = warp(f1_hz);
+        double w2 = warp(f2_hz);
+        to_bandpass(f, std::sqrt(w1 * w2), w2 - w1);
+        break;
+    }
+    }
+    bilinear(f, fs_hz);
+    return to_sections(f);
+}
+
+Biquad design_notch(double fs_hz, double f0_hz, double q) {
+    if (fs_hz <= 0) fs_hz = 200.0;
+    if (f0_hz <= 0) f0_hz = 60.0;
+    if (q <= 0) q = 30.0;
+
+    double w0 = 2.0 * M_PI * (f0_hz / fs_hz);
+    double cosw0 = std::cos(w0);
+    double sinw0 = std::sin(w0);
+    double alpha = sinw0 / (2.0 * q);
+
+    double a0 = 1.0 + alpha;
+
+    Biquad s;
+    s.b0 = 1.0 / a0;
+    s.b1 = -2.0 * cosw0 / a0;
+    s.b2 = 1.0 / a0;
+    s.a1 = -2.0 * cosw0 / a0;
+    s.a2 = (1.0 - alpha) / a0;
+    return s;
+}
+
+std::vector<Biquad> design_hum_bank(double fs_hz, double f0_hz, int harmonics, double q) {
+    std::vector<Biquad> out;
+    if (fs_hz <= 0.0 || f0_hz <= 0.0 || q <= 0.0) return out;
+
+    const double nyq = 0.5 * fs_hz;
+    std::vector<double> placed;
+    for (int k = 1; k <= harmonics; ++k) {
+        const double f = k * f0_hz;
+        const double fa = std::fabs(f - fs_hz * std::round(f / fs_hz));
+        const double bw = f / q;
+
+        if (fa < 0.5 * bw || fa > nyq - 0.5 * bw) continue;
+        bool dup = false;
+        for (double p : placed) dup = dup || std::fabs(p - fa) < 0.5 * bw;
+        if (dup) continue;
+
+        placed.push_back(fa);
+        out.push_back(design_notch(fs_hz, fa, fa / bw));
+    }
+    return out;
+}
+
+// ---- SosFilter ---------------------------------------------------------------
+
+void SosFilter::reset() {
+    ready_ = false;
+    n_ch_ = 0;
+    sec_.clear();
+    z_.clear();
+}
+
+void SosFilter::configure(size_t n_ch, const std::vector<Biquad>& sections, SosForm form) {
+    n_ch_ = n_ch;
+    form_ = form;
+    sec_ = sections;
+    z_.assign((form_ == SosForm::Df1 ? 4 : 2) * sec_.size() * n_ch_, 0.0);
+    ready_ = true;
+}
+
+void SosFilter::set_sections(const std::vector<Biquad>& sections) {
+    if (sections.size() != sec_.size()) {
+        configure(n_ch_, sections, form_);
+        return;
+    }
+    sec_ = sections;
+}
+
+void SosFilter::process_inplace(std::vector<float>& x) {
+    process_inplace(x.data(), x.size());
+}
+
+void SosFilter::process_inplace(float* x, size_t n) {
+    if (!ready_) return;
+    if (n != n_ch_) return;
+
+    for (size_t i = 0; i < n_ch_; ++i) {
+        double v = static_cast<double>(x[i]);
+        for (size_t s = 0; s < sec_.size(); ++s) {
+            const Biquad& q = sec_[s];
+            if (form_ == SosForm::Df1) {
+                double* x1 = z_.data() + 4 * s * n_ch_;
+                double* x2 = x1 + n_ch_;
+                double* y1 = x2 + n_ch_;
+                double* y2 = y1 + n_ch_;
+                double y = q.b0 * v + q.b1 * x1[i] + q.b2 * x2[i] - q.a1 * y1[i] - q.a2 * y2[i];
+                x2[i] = x1[i];
+                x1[i] = v;
+                y2[i] = y1[i];
+                y1[i] = y;
+                v = y;
+                continue;
+            }
+            double* z1 = z_.data() + 2 * s * n_ch_;
+            double* z2 = z1 + n_ch_;
+            double y = q.b0 * v + z1[i];
+            z1[i] = q.b1 * v - q.a1 * y + z2[i];
+            z2[i] = q.b2 * v - q.a2 * y;
+            v = y;
+        }
+        x[i] = static_cast<float>(v);
+    }
+}
+
+}
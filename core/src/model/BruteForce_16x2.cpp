@@ -1,9 +1,532 @@
 #include "hub/model/BruteForce_16x2.h"
+#include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define HUB_BF_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define HUB_TARGET_AVX2_FMA
+#else
+#define HUB_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#endif
+#endif
 
 namespace hub {
 
+// ---- Grid kernels ------------------------------------------------------------
+//
+// Both solves are linear least squares per grid point, so the residual has a
+// closed form from the dot products the fit already needs:
+//   static:  err = |V|^2 - num^2 / den             (num = V.inv, den = inv.inv)
+//   dynamic: err = |y|^2 - (q1 b1 + q2 b2)
+// den (= A22) only depends on the point and is precomputed, rounded the way
+// the scan rounds its dot products: for the first point itself A12 = -A11
+// then holds exactly and det = 0 skips it, as before. The scans keep
+// the first point with the smallest error, as the plain loops did; the AVX2
+// versions take four points per step and keep a best per lane, and the lanes
+// are merged by (err, index).
+
+namespace {
+
+struct Best {
+    double err = 1e300;
+    int idx = -1;
+    double q1 = 0.0;
+    double q2 = 0.0;
+
+    void take(double e, int i, double a, double b) {
+        if (e < err || (e == err && i < idx)) {
+            err = e;
+            idx = i;
+            q1 = a;
+            q2 = b;
+        }
+    }
+};
+
+struct StaticScan {
+    const double* const* inv;   // NSENS rows
+    const double* den;
+    const double* V;
+    double vv;
+};
+
+struct DynamicScan {
+    const double* const* inv;
+    const double* den;
+    const double* lhs;
+    const double* inv1;         // the first point's column
+    double yy, A11, b1;
+};
+
+constexpr int kS = BruteForce_16x2Solver::NSENS;
+
+// One grid point; false where the fit is singular.
+inline bool static_at(const StaticScan& s, int g, double& err, double& q) {
+    const double den = s.den[g];
+    if (den < 1e-18) return false;
+    double num = 0.0;
+    for (int j = 0; j < kS; ++j) num += s.V[j] * s.inv[j][g];
+    q = num / den;
+    err = s.vv - q * num;
+    return true;
+}
+
+inline bool dynamic_at(const DynamicScan& s, int g, double& err, double& q1, double& q2) {
+    double c = 0.0, b2 = 0.0;
+    for (int j = 0; j < kS; ++j) {
+        c += s.inv1[j] * s.inv[j][g];
+        b2 += s.lhs[j] * s.inv[j][g];
+    }
+    const double A22 = s.den[g];
+    const double A12 = -c;
+    const double det = s.A11 * A22 - A12 * A12;
+    if (std::fabs(det) < 1e-18) return false;
+    q1 = ( A22 * s.b1 - A12 * b2) / det;
+    q2 = (-A12 * s.b1 + s.A11 * b2) / det;
+    err = s.yy - (q1 * s.b1 + q2 * b2);
+    return true;
+}
+
+Best static_scalar(const StaticScan& s, int g0, int g1) {
+    Best best;
+    for (int g = g0; g < g1; ++g) {
+        double err, q;
+        if (static_at(s, g, err, q) && err < best.err) best = Best{err, g, q, 0.0};
+    }
+    return best;
+}
+
+Best dynamic_scalar(const DynamicScan& s, int g0, int g1) {
+    Best best;
+    for (int g = g0; g < g1; ++g) {
+        double err, q1, q2;
+        if (dynamic_at(s, g, err, q1, q2) && err < best.err) best = Best{err, g, q1, q2};
+    }
+    return best;
+}
+
+#ifdef HUB_BF_X86
+HUB_TARGET_AVX2_FMA Best merge_lanes(__m256d err, __m256d idx, __m256d q1, __m256d q2) {
+    alignas(32) double e[4], i[4], a[4], b[4];
+    _mm256_store_pd(e, err);
+    _mm256_store_pd(i, idx);
+    _mm256_store_pd(a, q1);
+    _mm256_store_pd(b, q2);
+    // The ymm arguments keep the compiler from clearing the upper halves on
+    // return; left dirty, they slow down later SSE code (grid rebuilds, the
+    // filters) several times over on some CPUs.
+    _mm256_zeroupper();
+    Best best;
+    for (int l = 0; l < 4; ++l) {
+        if (i[l] >= 0.0) best.take(e[l], (int)i[l], a[l], b[l]);
+    }
+    return best;
+}
+
+// g0 and g1 are multiples of 4; padded points have den = 0 and are masked out.
+HUB_TARGET_AVX2_FMA Best static_avx2(const StaticScan& s, int g0, int g1) {
+    const __m256d vv = _mm256_set1_pd(s.vv);
+    const __m256d tiny = _mm256_set1_pd(1e-18);
+    const __m256d inf = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    __m256d bestErr = _mm256_set1_pd(1e300);
+    __m256d bestIdx = _mm256_set1_pd(-1.0);
+    __m256d bestQ = _mm256_setzero_pd();
+    __m256d gi = _mm256_add_pd(_mm256_set1_pd((double)g0), _mm256_setr_pd(0.0, 1.0, 2.0, 3.0));
+    const __m256d four = _mm256_set1_pd(4.0);
+
+    for (int g = g0; g < g1; g += 4) {
+        __m256d num = _mm256_setzero_pd();
+        for (int j = 0; j < kS; ++j) {
+            num = _mm256_fmadd_pd(_mm256_set1_pd(s.V[j]), _mm256_load_pd(s.inv[j] + g), num);
+        }
+        const __m256d den = _mm256_load_pd(s.den + g);
+        const __m256d ok = _mm256_cmp_pd(den, tiny, _CMP_GE_OQ);
+        const __m256d q = _mm256_div_pd(num, den);
+        const __m256d err = _mm256_blendv_pd(inf, _mm256_fnmadd_pd(q, num, vv), ok);
+
+        const __m256d lt = _mm256_cmp_pd(err, bestErr, _CMP_LT_OQ);
+        bestErr = _mm256_blendv_pd(bestErr, err, lt);
+        bestIdx = _mm256_blendv_pd(bestIdx, gi, lt);
+        bestQ = _mm256_blendv_pd(bestQ, q, lt);
+        gi = _mm256_add_pd(gi, four);
+    }
+    return merge_lanes(bestErr, bestIdx, bestQ, _mm256_setzero_pd());
+}
+
+HUB_TARGET_AVX2_FMA Best dynamic_avx2(const DynamicScan& s, int g0, int g1) {
+    const __m256d yy = _mm256_set1_pd(s.yy);
+    const __m256d A11 = _mm256_set1_pd(s.A11);
+    const __m256d b1 = _mm256_set1_pd(s.b1);
+    const __m256d tiny = _mm256_set1_pd(1e-18);
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    const __m256d inf = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    __m256d bestErr = _mm256_set1_pd(1e300);
+    __m256d bestIdx = _mm256_set1_pd(-1.0);
+    __m256d bestQ1 = _mm256_setzero_pd();
+    __m256d bestQ2 = _mm256_setzero_pd();
+    __m256d gi = _mm256_add_pd(_mm256_set1_pd((double)g0), _mm256_setr_pd(0.0, 1.0, 2.0, 3.0));
+    const __m256d four = _mm256_set1_pd(4.0);
+
+    for (int g = g0; g < g1; g += 4) {
+        __m256d c = _mm256_setzero_pd();
+        __m256d b2 = _mm256_setzero_pd();
+        for (int j = 0; j < kS; ++j) {
+            const __m256d v = _mm256_load_pd(s.inv[j] + g);
+            c = _mm256_fmadd_pd(_mm256_set1_pd(s.inv1[j]), v, c);
+            b2 = _mm256_fmadd_pd(_mm256_set1_pd(s.lhs[j]), v, b2);
+        }
+        const __m256d A22 = _mm256_load_pd(s.den + g);
+        const __m256d A12 = _mm256_sub_pd(_mm256_setzero_pd(), c);
+        const __m256d det = _mm256_sub_pd(_mm256_mul_pd(A11, A22), _mm256_mul_pd(A12, A12));
+        const __m256d ok = _mm256_cmp_pd(_mm256_and_pd(det, absMask), tiny, _CMP_GE_OQ);
+
+        const __m256d q1 = _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(A22, b1), _mm256_mul_pd(A12, b2)), det);
+        const __m256d q2 = _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(A11, b2), _mm256_mul_pd(A12, b1)), det);
+        const __m256d fit = _mm256_add_pd(_mm256_mul_pd(q1, b1), _mm256_mul_pd(q2, b2));
+        const __m256d err = _mm256_blendv_pd(inf, _mm256_sub_pd(yy, fit), ok);
+
+        const __m256d lt = _mm256_cmp_pd(err, bestErr, _CMP_LT_OQ);
+        bestErr = _mm256_blendv_pd(bestErr, err, lt);
+        bestIdx = _mm256_blendv_pd(bestIdx, gi, lt);
+        bestQ1 = _mm256_blendv_pd(bestQ1, q1, lt);
+        bestQ2 = _mm256_blendv_pd(bestQ2, q2, lt);
+        gi = _mm256_add_pd(gi, four);
+    }
+    return merge_lanes(bestErr, bestIdx, bestQ1, bestQ2);
+}
+#endif
+
+// One solve's scan, cut into `parts` parts of `chunk` points (a multiple of 4);
+// the last part runs to the end. The SIMD scans run to the padded stride, the
+// scalar ones stop at the grid size.
+struct ScanJob {
+    const StaticScan* st = nullptr;
+    const DynamicScan* dyn = nullptr;
+    bool simd = false;
+    int ng = 0;
+    int stride = 0;
+    int chunk = 0;
+    int parts = 1;
+    Best* out = nullptr;
+};
+
+Best scan_range(const ScanJob& j, int g0, int g1) {
+#ifdef HUB_BF_X86
+    if (j.simd) return j.st ? static_avx2(*j.st, g0, g1) : dynamic_avx2(*j.dyn, g0, g1);
+#endif
+    g1 = std::min(g1, j.ng);
+    if (g0 >= g1) return Best{};
+    return j.st ? static_scalar(*j.st, g0, g1) : dynamic_scalar(*j.dyn, g0, g1);
+}
+
+void scan_part(void* ctx, int part) {
+    const ScanJob& j = *static_cast<const ScanJob*>(ctx);
+    const int g0 = part * j.chunk;
+    const int g1 = part == j.parts - 1 ? j.stride : std::min(g0 + j.chunk, j.stride);
+    j.out[part] = g0 < g1 ? scan_range(j, g0, g1) : Best{};
+}
+
+// Below this many points per thread, waking the workers costs more than the
+// share of the scan they take over.
+constexpr int kMinPointsPerPart = 8192;
+constexpr int kMaxThreads = 64;
+
+}
+
+// Persistent workers for the grid scans. run() hands part 0 to the caller and
+// part i to worker i, and returns when every part is done.
+class GridScanPool {
+public:
+    explicit GridScanPool(int workers) {
+        for (int i = 0; i < workers; ++i) threads_.emplace_back([this, i]() { loop(i + 1); });
+    }
+
+    ~GridScanPool() {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    int workers() const { return (int)threads_.size(); }
+
+    void run(int parts, void (*fn)(void*, int), void* ctx) {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            fn_ = fn;
+            ctx_ = ctx;
+            parts_ = parts;
+            pending_ = parts - 1;
+            ++gen_;
+        }
+        wake_.notify_all();
+
+        fn(ctx, 0);
+
+        std::unique_lock<std::mutex> lk(mu_);
+        done_.wait(lk, [this]() { return pending_ == 0; });
+    }
+
+private:
+    void loop(int id) {
+        uint64_t seen = 0;
+        for (;;) {
+            void (*fn)(void*, int) = nullptr;
+            void* ctx = nullptr;
+            {
+                std::unique_lock<std::mutex> lk(mu_);
+                wake_.wait(lk, [&]() { return stop_ || gen_ != seen; });
+                if (stop_) return;
+                seen = gen_;
+                if (id >= parts_) continue;
+                fn = fn_;
+                ctx = ctx_;
+            }
+
+            fn(ctx, id);
+
+            std::lock_guard<std::mutex> lk(mu_);
+            if (--pending_ == 0) done_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> threads_;
+    std::mutex mu_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    uint64_t gen_ = 0;
+    int parts_ = 0;
+    int pending_ = 0;
+    bool stop_ = false;
+    void (*fn_)(void*, int) = nullptr;
+    void* ctx_ = nullptr;
+};
+
+namespace {
+
+// Merging the parts in index order keeps the serial result: the first point
+// with the smallest error.
+Best run_scan(ScanJob job, GridScanPool* pool, int parts) {
+    if (!pool || parts <= 1) {
+        return scan_range(job, 0, job.simd ? job.stride : job.ng);
+    }
+
+    Best out[kMaxThreads];
+    // Round the share up, then to whole AVX2 vectors, so the parts cover the
+    // grid.
+    job.chunk = ((job.stride + parts - 1) / parts + 3) & ~3;
+    job.parts = parts;
+    assert((int64_t)job.chunk * parts >= job.stride);
+    job.out = out;
+    pool->run(parts, scan_part, &job);
+
+    Best best;
+    for (int i = 0; i < parts; ++i) {
+        if (out[i].idx >= 0) best.take(out[i].err, out[i].idx, out[i].q1, out[i].q2);
+    }
+    return best;
+}
+
+}
+
+BruteForce_16x2Solver::~BruteForce_16x2Solver() = default;
+
+void BruteForce_16x2Solver::set_threads(int n) {
+    if (n <= 0) n = (int)std::thread::hardware_concurrency();
+    n = std::clamp(n, 1, kMaxThreads);
+    if (n == threads_) return;
+    threads_ = n;
+    pool_.reset();
+}
+
+int BruteForce_16x2Solver::scan_parts() const {
+    const int by_size = (int)grid_.size() / kMinPointsPerPart;
+    return std::max(1, std::min(threads_, by_size));
+}
+
+GridScanPool* BruteForce_16x2Solver::pool_for(int parts) {
+    if (parts <= 1) return nullptr;
+    if (!pool_) pool_ = std::make_unique<GridScanPool>(threads_ - 1);
+    return pool_.get();
+}
+
+// ---- Pyramid search -----------------------------------------------------------
+//
+// Level l looks at every 2^l-th grid index per axis. The coarsest level is a
+// plain scan of its lattice (plus the last index of each axis, so the edges
+// of the volume are covered); each finer level evaluates the 5^3 points at
+// offsets -2..2 (in units of its spacing) around the top_k points found so
+// far, which spans one cell of the level above in every direction. Points
+// already evaluated in this solve are skipped and count once.
+
+namespace {
+
+constexpr int kPyrRadius = 2;
+constexpr int kPyrNeighbours = (2 * kPyrRadius + 1) * (2 * kPyrRadius + 1) * (2 * kPyrRadius + 1);
+
+// Lattice points of one axis of n indices at spacing f.
+int lattice_count(int n, int f) {
+    if (n <= 0) return 0;
+    return (n - 1) / f + 1 + ((n - 1) % f ? 1 : 0);
+}
+
+template <class Cand>
+void keep_best(std::vector<Cand>& c, int k) {
+    if ((int)c.size() > k) {
+        std::partial_sort(c.begin(), c.begin() + k, c.end());
+        c.resize((size_t)k);
+    } else {
+        std::sort(c.begin(), c.end());
+    }
+}
+
+}
+
+void BruteForce_16x2Solver::set_pyramid(bool on, int top_k, int max_evals) {
+    pyramid_ = on;
+    pyr_top_k_ = std::clamp(top_k, 1, 64);
+    pyr_max_evals_ = std::max(max_evals, 64);
+    plan_pyramid();
+}
+
+// Fewest levels whose expected cost (coarse scan plus a full neighbourhood per
+// candidate and level) fits the budget; else the cheapest plan whose coarse
+// lattice fits. The coarsest level's lattice is at most 2 x 2 x 2 points, so
+// one always does.
+void BruteForce_16x2Solver::plan_pyramid() {
+    pyr_levels_ = 0;
+    for (auto& a : pyr_axis_) a.clear();
+    if ((long long)grid_.size() <= pyr_max_evals_) return;
+
+    const int nmax = std::max({nx_, ny_, nz_});
+    const long long per_level = (long long)(pyr_top_k_ + 1) * kPyrNeighbours;
+    long long best_cost = std::numeric_limits<long long>::max();
+    for (int l = 1; l < 31 && (1 << (l - 1)) < nmax - 1; ++l) {
+        const int f = 1 << l;
+        const long long coarse = (long long)lattice_count(nx_, f) * lattice_count(ny_, f) * lattice_count(nz_, f);
+        if (coarse > pyr_max_evals_) continue;
+        const long long cost = coarse + per_level * l;
+        if (cost <= pyr_max_evals_) {
+            pyr_levels_ = l;
+            break;
+        }
+        if (cost < best_cost) {
+            best_cost = cost;
+            pyr_levels_ = l;
+        }
+    }
+
+    const int f = 1 << pyr_levels_;
+    const int n[3] = {nx_, ny_, nz_};
+    for (int a = 0; a < 3; ++a) {
+        for (int i = 0; i < n[a]; i += f) pyr_axis_[a].push_back(i);
+        if (n[a] > 0 && pyr_axis_[a].back() != n[a] - 1) pyr_axis_[a].push_back(n[a] - 1);
+    }
+}
+
+// eval(g, err, q1, q2) fits one grid point. seed >= 0 is refined at every
+// level next to the top_k candidates. The coarse lattice is scanned in full;
+// refining stops at pyr_max_evals_ evaluations.
+template <class Eval>
+int BruteForce_16x2Solver::pyramid_search(Eval&& eval, int seed, double& out_err, double& out_q1, double& out_q2) {
+    if (++pyr_tag_ == 0) {
+        std::fill(pyr_seen_.begin(), pyr_seen_.end(), 0);
+        pyr_tag_ = 1;
+    }
+
+    Best best;
+    int evals = 0;
+    std::vector<PyrCand>& level = pyr_level_;
+    level.clear();
+    auto visit = [&](int g) {
+        if (pyr_seen_[g] == pyr_tag_) return;
+        pyr_seen_[g] = pyr_tag_;
+        ++evals;
+        double err, q1 = 0.0, q2 = 0.0;
+        if (eval(g, err, q1, q2)) {
+            best.take(err, g, q1, q2);
+            level.push_back({err, g});
+        }
+    };
+
+    for (int ix : pyr_axis_[0]) {
+        for (int iy : pyr_axis_[1]) {
+            for (int iz : pyr_axis_[2]) visit((ix * ny_ + iy) * nz_ + iz);
+        }
+    }
+    keep_best(level, pyr_top_k_);
+
+    std::vector<int>& centres = pyr_centres_;
+    bool room = evals < pyr_max_evals_;
+    for (int l = pyr_levels_ - 1; l >= 0 && room; --l) {
+        const int h = 1 << l;
+        centres.clear();
+        for (const PyrCand& c : level) centres.push_back(c.idx);
+        if (seed >= 0 && std::find(centres.begin(), centres.end(), seed) == centres.end()) centres.push_back(seed);
+
+        for (int c : centres) {
+            const int ix = c / (ny_ * nz_), iy = (c / nz_) % ny_, iz = c % nz_;
+            for (int dx = -kPyrRadius; dx <= kPyrRadius && room; ++dx) {
+                const int x = ix + dx * h;
+                if (x < 0 || x >= nx_) continue;
+                for (int dy = -kPyrRadius; dy <= kPyrRadius && room; ++dy) {
+                    const int y = iy + dy * h;
+                    if (y < 0 || y >= ny_) continue;
+                    for (int dz = -kPyrRadius; dz <= kPyrRadius && room; ++dz) {
+                        const int z = iz + dz * h;
+                        if (z < 0 || z >= nz_) continue;
+                        visit((x * ny_ + y) * nz_ + z);
+                        room = evals < pyr_max_evals_;
+                    }
+                }
+            }
+        }
+        // The previous candidates stay in the running.
+        keep_best(level, pyr_top_k_);
+    }
+
+    last_evals_ = (size_t)evals;
+    out_err = best.err;
+    out_q1 = best.q1;
+    out_q2 = best.q2;
+    return best.idx;
+}
+
+bool BruteForce_16x2Solver::simd_available() {
+#if defined(HUB_BF_X86) && defined(_MSC_VER) && !defined(__clang__)
+    static const bool ok = []() {
+        int r[4] = {0, 0, 0, 0};
+        __cpuid(r, 0);
+        const int max_leaf = r[0];
+        __cpuid(r, 1);
+        const bool fma = (r[2] >> 12) & 1;
+        const bool osxsave_avx = ((r[2] >> 27) & 1) && ((r[2] >> 28) & 1);
+        if (!fma || !osxsave_avx || max_leaf < 7 || (_xgetbv(0) & 6) != 6) return false;
+        __cpuidex(r, 7, 0);
+        return ((r[1] >> 5) & 1) != 0;
+    }();
+    return ok;
+#elif defined(HUB_BF_X86)
+    static const bool ok = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }();
+    return ok;
+#else
+    return false;
+#endif
+}
+
 std::once_flag BruteForce_16x2Solver::sensors_once_;
 std::array<Vec3d, BruteForce_16x2Solver::NSENS> BruteForce_16x2Solver::sensors_{};
 
@@ -90,24 +613,46 @@ void BruteForce_16x2Solver::rebuild_grid() {
     ensure_sensors();
 
     grid_.clear();
-    invR_.clear();
+
+    // Same loops as below, so the counts match the points generated.
+    nx_ = ny_ = nz_ = 0;
+    for (double x = xmin_; x <= xmax_ + 1e-12; x += step_) ++nx_;
+    for (double y = ymin_; y <= ymax_ + 1e-12; y += step_) ++ny_;
+    for (double z = zmin_; z <= zmax_ + 1e-12; z += step_) ++nz_;
 
     for (double x = xmin_; x <= xmax_ + 1e-12; x += step_) {
         for (double y = ymin_; y <= ymax_ + 1e-12; y += step_) {
             for (double z = zmin_; z <= zmax_ + 1e-12; z += step_) {
                 grid_.push_back({x,y,z});
-
-                std::array<double, NSENS> inv{};
-                Vec3d r{x,y,z};
-                for (int j = 0; j < NSENS; ++j) {
-                    double d = dist3(r, sensors_[j]);
-                    if (d < 1e-9) d = 1e-9;
-                    inv[j] = 1.0 / d;
-                }
-                invR_.push_back(inv);
             }
         }
     }
+
+    // One spare row's worth of slack to move the start onto 32 bytes.
+    stride_ = (grid_.size() + 3) & ~(size_t)3;
+    inv_buf_.assign((size_t)(NSENS + 2) * stride_ + 4, 0.0);
+    inv_off_ = ((32 - (uintptr_t)inv_buf_.data() % 32) % 32) / sizeof(double);
+
+    double* base = inv_buf_.data() + inv_off_;
+    double* den = base + (size_t)NSENS * stride_;
+    double* den_fma = den + stride_;
+    for (size_t g = 0; g < grid_.size(); ++g) {
+        Vec3d r{grid_[g].x, grid_[g].y, grid_[g].z};
+        double sum = 0.0, sum_fma = 0.0;
+        for (int j = 0; j < NSENS; ++j) {
+            double d = dist3(r, sensors_[j]);
+            if (d < 1e-9) d = 1e-9;
+            const double inv = 1.0 / d;
+            base[(size_t)j * stride_ + g] = inv;
+            sum += inv * inv;
+            sum_fma = std::fma(inv, inv, sum_fma);
+        }
+        den[g] = sum;
+        den_fma[g] = sum_fma;
+    }
+    pyr_seen_.assign(grid_.size(), 0);
+    pyr_tag_ = 0;
+    plan_pyramid();
     grid_built_ = true;
 }
 
@@ -128,43 +673,37 @@ void BruteForce_16x2Solver::reset() {
 int BruteForce_16x2Solver::solve_static_idx(const double V[NSENS], Vec3d& out_r, double& out_q, double& out_err) {
     if (!grid_built_) rebuild_grid();
 
-    double best_err = 1e300;
-    int best_idx = -1;
-    double best_q = 0.0;
-
-    int NG = (int)grid_.size();
-    for (int gi = 0; gi < NG; ++gi) {
-        const auto& inv = invR_[gi];
-
-        double num = 0.0, den = 0.0;
-        for (int j = 0; j < NSENS; ++j) {
-            num += V[j] * inv[j];
-            den += inv[j] * inv[j];
-        }
-        if (den < 1e-18) continue;
-
-        double q = num / den;
+    const double* rows[NSENS];
+    for (int j = 0; j < NSENS; ++j) rows[j] = inv_row(j);
 
-        double err = 0.0;
-        for (int j = 0; j < NSENS; ++j) {
-            double Vmodel = q * inv[j];
-            double diff = V[j] - Vmodel;
-            err += diff * diff;
-        }
+    // The pyramid evaluates with the scalar kernels: plainly summed den.
+    const bool pyr = pyramid_ && pyr_levels_ > 0;
+    StaticScan scan{rows, pyr ? inv_row(NSENS) : den_row(), V, 0.0};
+    for (int j = 0; j < NSENS; ++j) scan.vv += V[j] * V[j];
 
-        if (err < best_err) {
-            best_err = err;
-            best_idx = gi;
-            best_q = q;
-        }
+    Best best;
+    if (pyr) {
+        best.idx = pyramid_search([&scan](int g, double& err, double& q1, double&) {
+            return static_at(scan, g, err, q1);
+        }, -1, best.err, best.q1, best.q2);
+    } else {
+        ScanJob job;
+        job.st = &scan;
+        job.simd = simd_;
+        job.ng = (int)grid_.size();
+        job.stride = (int)stride_;
+        const int parts = scan_parts();
+        best = run_scan(job, pool_for(parts), parts);
+        last_evals_ = grid_.size();
     }
 
-    if (best_idx >= 0) out_r = {grid_[best_idx].x, grid_[best_idx].y, grid_[best_idx].z};
+    if (best.idx >= 0) out_r = {grid_[best.idx].x, grid_[best.idx].y, grid_[best.idx].z};
     else out_r = {0,0,0};
 
-    out_q = best_q;
-    out_err = best_err;
-    return best_idx;
+    out_q = best.q1;
+    // Cancellation can leave a perfect fit a hair below zero.
+    out_err = best.idx >= 0 ? std::max(best.err, 0.0) : best.err;
+    return best.idx;
 }
 
 int BruteForce_16x2Solver::solve_dynamic_idx(const double V1[NSENS], const double V2[NSENS], int idx_r1,
@@ -178,69 +717,51 @@ int BruteForce_16x2Solver::solve_dynamic_idx(const double V1[NSENS], const doubl
         return -1;
     }
 
-    const auto& inv1 = invR_[idx_r1];
+    const double* rows[NSENS];
+    double inv1[NSENS];
+    for (int j = 0; j < NSENS; ++j) {
+        rows[j] = inv_row(j);
+        inv1[j] = rows[j][idx_r1];
+    }
 
     double lhs[NSENS];
     for (int j = 0; j < NSENS; ++j) {
         lhs[j] = (V1[j] + V2[j]) / (2.0 * RC_R_ * RC_C_) + (V2[j] - V1[j]);
     }
 
-    double best_err = 1e300;
-    int best_idx = -1;
-    double best_q1k = 0.0;
-    double best_q2k = 0.0;
-
-    int NG = (int)grid_.size();
-    for (int gi = 0; gi < NG; ++gi) {
-        const auto& inv2 = invR_[gi];
-
-        double A11 = 0.0, A22 = 0.0, A12 = 0.0;
-        double b1 = 0.0, b2 = 0.0;
-
-        for (int j = 0; j < NSENS; ++j) {
-            double phi1 = -inv1[j];
-            double phi2 =  inv2[j];
-            double y = lhs[j];
-
-            A11 += phi1 * phi1;
-            A22 += phi2 * phi2;
-            A12 += phi1 * phi2;
-
-            b1  += phi1 * y;
-            b2  += phi2 * y;
-        }
-
-        double det = A11 * A22 - A12 * A12;
-        if (std::fabs(det) < 1e-18) continue;
-
-        double q1k = ( A22 * b1 - A12 * b2) / det;
-        double q2k = (-A12 * b1 + A11 * b2) / det;
-
-        double err = 0.0;
-        for (int j = 0; j < NSENS; ++j) {
-            double phi1 = -inv1[j];
-            double phi2 =  inv2[j];
-            double y = lhs[j];
-            double yhat = phi1 * q1k + phi2 * q2k;
-            double diff = y - yhat;
-            err += diff * diff;
-        }
+    // phi1 = -inv1 is the same for every candidate: A11 and b1 are fixed.
+    const bool pyr = pyramid_ && pyr_levels_ > 0;
+    const double* den = pyr ? inv_row(NSENS) : den_row();
+    DynamicScan scan{rows, den, lhs, inv1, 0.0, den[idx_r1], 0.0};
+    for (int j = 0; j < NSENS; ++j) {
+        scan.yy += lhs[j] * lhs[j];
+        scan.b1 -= inv1[j] * lhs[j];
+    }
 
-        if (err < best_err) {
-            best_err = err;
-            best_idx = gi;
-            best_q1k = q1k;
-            best_q2k = q2k;
-        }
+    Best best;
+    if (pyr) {
+        // The source moves little between samples: refine around r1 as well.
+        best.idx = pyramid_search([&scan](int g, double& err, double& q1, double& q2) {
+            return dynamic_at(scan, g, err, q1, q2);
+        }, idx_r1, best.err, best.q1, best.q2);
+    } else {
+        ScanJob job;
+        job.dyn = &scan;
+        job.simd = simd_;
+        job.ng = (int)grid_.size();
+        job.stride = (int)stride_;
+        const int parts = scan_parts();
+        best = run_scan(job, pool_for(parts), parts);
+        last_evals_ = grid_.size();
     }
 
-    if (best_idx >= 0) out_r2 = {grid_[best_idx].x, grid_[best_idx].y, grid_[best_idx].z};
+    if (best.idx >= 0) out_r2 = {grid_[best.idx].x, grid_[best.idx].y, grid_[best.idx].z};
     else out_r2 = {0,0,0};
 
-    out_q1k = best_q1k;
-    out_q2k = best_q2k;
-    out_err = best_err;
-    return best_idx;
+    out_q1k = best.q1;
+    out_q2k = best.q2;
+    out_err = best.idx >= 0 ? std::max(best.err, 0.0) : best.err;
+    return best.idx;
 }
 
 Vec3d BruteForce_16x2Solver::ema_cascade_update(const Vec3d& x) {
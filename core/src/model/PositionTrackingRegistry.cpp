@@ -1,6 +1,7 @@
 #include "hub/model/PositionTrackingRegistry.h"
 #include "hub/model/BruteForce_16x2.h"
 
+#include <cmath>
 #include <functional>
 #include <vector>
 #include <string>
@@ -72,7 +73,11 @@ static void ensure_registered() {
                 {"ymax", "Grid y max", -1.0, 1.0, 0.03, 0.001, 5, false},
                 {"zmin", "Grid z min", -1.0, 1.0, 0.01, 0.001, 5, false},
                 {"zmax", "Grid z max", -1.0, 1.0, 0.01, 0.001, 5, false},
-                {"step", "Grid step", 1e-6, 0.1, 0.001, 0.0001, 6, false}
+                {"step", "Grid step", 1e-6, 0.1, 0.001, 0.0001, 6, false},
+                {"threads", "Threads (0 = auto)", 0.0, 64.0, 0.0, 1.0, 0, false},
+                {"pyramid", "Coarse-to-fine search (0/1)", 0.0, 1.0, 0.0, 1.0, 0, false},
+                {"top_k", "Pyramid candidates (more = closer to full scan)", 1.0, 64.0, 4.0, 1.0, 0, false},
+                {"max_evals", "Pyramid max points/solve (refining stops there)", 64.0, 1e7, 4096.0, 256.0, 0, false}
             };
         }
 
@@ -86,8 +91,9 @@ static void ensure_registered() {
 
         void set_params(const std::vector<double>& v) override {
             auto d = defaults();
+            // Settings saved before a parameter existed stop short of it.
             std::vector<double> a = v;
-            if (a.size() < d.size()) a.resize(d.size(), 0.0);
+            for (size_t i = a.size(); i < d.size(); ++i) a.push_back(d[i]);
 
             double rc_r = a[0];
             double rc_c = a[1];
@@ -98,8 +104,14 @@ static void ensure_registered() {
             double ymin = a[6], ymax = a[7];
             double zmin = a[8], zmax = a[9];
             double step = a[10];
+            int threads = (int)std::lround(a[11]);
+            bool pyramid = a[12] >= 0.5;
+            int top_k = (int)std::lround(a[13]);
+            int max_evals = (int)std::lround(a[14]);
 
             solver_.set_params(rc_r, rc_c, ema_a, quiet);
+            solver_.set_threads(threads);
+            solver_.set_pyramid(pyramid, top_k, max_evals);
             solver_.set_grid(xmin, xmax, ymin, ymax, zmin, zmax, step);
 
             params_ = a;
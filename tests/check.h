@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdio>
+
+// Minimal assertions for the test executables: a failed CHECK prints where and
+// why and marks the run failed; main() returns hub_test_result().
+inline int& hub_test_failures() {
+    static int n = 0;
+    return n;
+}
+
+#define CHECK(cond, ...)                                                     \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed: ", __FILE__,      \
+                         __LINE__, #cond);                                   \
+            std::fprintf(stderr, __VA_ARGS__);                               \
+            std::fprintf(stderr, "\n");                                      \
+            ++hub_test_failures();                                           \
+        }                                                                    \
+    } while (0)
+
+inline int hub_test_result() {
+    if (hub_test_failures() == 0) return 0;
+    std::fprintf(stderr, "%d check(s) failed\n", hub_test_failures());
+    return 1;
+}
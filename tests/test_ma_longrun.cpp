@@ -0,0 +1,101 @@
+// The moving average keeps double running sums and rebuilds them from the
+// window every MAFilter::resync_interval() frames. Run it for many of those
+// intervals, standalone and inside Pipeline (fused and generic paths, every
+// SIMD level), and compare each output with the mean of the window computed
+// from scratch.
+
+#include "check.h"
+#include "hub/Pipeline.h"
+#include "hub/filters/MA.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <string>
+#include <vector>
+
+static const size_t kCh = 19;
+
+// Large per-channel offsets, small noise and occasional steps: the sums are
+// big next to what enters and leaves them.
+static std::vector<float> make_input(size_t frames) {
+    std::vector<float> x(frames * kCh);
+    uint32_t seed = 1;
+    float step = 0.0f;
+    for (size_t i = 0; i < frames; ++i) {
+        if (i % 2999 == 0) step = (i / 2999) % 2 ? 500.0f : -250.0f;
+        for (size_t c = 0; c < kCh; ++c) {
+            seed = seed * 1664525u + 1013904223u;
+            const float noise = (float)(seed >> 8) * (1.0f / 8388608.0f) - 1.0f;
+            x[i * kCh + c] = 1000.0f * (float)(c + 1) + step + noise;
+        }
+    }
+    return x;
+}
+
+// Mean of frames i-win+1..i of channel c, with frames before the start equal to
+// frame 0 (the window starts filled with the first frame). Neumaier sum.
+static double window_mean(const std::vector<float>& x, size_t i, size_t c, size_t win) {
+    double s = 0.0, comp = 0.0;
+    for (size_t k = 0; k < win; ++k) {
+        const size_t f = i >= k ? i - k : 0;
+        const double v = (double)x[f * kCh + c];
+        const double t = s + v;
+        comp += std::fabs(s) >= std::fabs(v) ? (s - t) + v : (v - t) + s;
+        s = t;
+    }
+    return (s + comp) / (double)win;
+}
+
+template <class Step>
+static void check_run(const char* name, const std::vector<float>& x, size_t frames, size_t win, Step step) {
+    // A fresh window sum costs win adds per value; sample the long windows.
+    const size_t every = win > 256 ? 37 : 1;
+    std::vector<float> y(kCh);
+    double worst = 0.0;
+    for (size_t i = 0; i < frames; ++i) {
+        std::copy(x.begin() + i * kCh, x.begin() + (i + 1) * kCh, y.begin());
+        step(y.data());
+        if (i % every != 0 && i + 1 != frames) continue;
+        for (size_t c = 0; c < kCh; ++c) {
+            const double ref = window_mean(x, i, c, win);
+            const double err = std::fabs((double)y[c] - ref);
+            // Rounding the mean to float, with a little room for the sums.
+            const double tol = 4.0 * FLT_EPSILON * std::max(1.0, std::fabs(ref));
+            worst = std::max(worst, err / tol);
+            CHECK(err <= tol, "%s win %zu frame %zu ch %zu: %.9g vs %.9g", name, win, i, c, (double)y[c], ref);
+        }
+    }
+    std::printf("%-24s win %5zu: %zu frames, %zu resyncs, worst %.3f of tolerance\n", name, win, frames,
+                frames / hub::MAFilter::resync_interval(win), worst);
+}
+
+int main() {
+    for (size_t win : {1u, 4u, 64u, 1000u, 6000u}) {
+        // At least ten resyncs, whatever the window.
+        const size_t frames = 10 * hub::MAFilter::resync_interval(win) + 123;
+        const std::vector<float> x = make_input(frames);
+
+        hub::MAFilter ma;
+        ma.configure(kCh, win);
+        check_run("MAFilter", x, frames, win, [&](float* v) { ma.process_inplace(v, kCh); });
+
+        // "bias" before "ma" is not the fused order, so that chain takes the
+        // generic path; nothing is captured, so the bias stage passes through.
+        for (const char* chain : {"ma", "bias,ma"}) {
+            for (int lv = 0; lv <= (int)hub::Pipeline::detected_simd(); ++lv) {
+                hub::PipelineConfig cfg;
+                std::string err;
+                const std::string spec = std::string(chain) + ":" + std::to_string(win);
+                CHECK(hub::parse_stage_chain(spec, cfg.stages, err), "%s: %s", spec.c_str(), err.c_str());
+                hub::Pipeline p;
+                p.set_config(cfg);
+                p.set_simd((hub::SimdLevel)lv);
+                p.ensure_initialized(kCh);
+                const std::string name = "Pipeline " + spec.substr(0, spec.find_last_of(':')) + " simd " + std::to_string(lv);
+                check_run(name.c_str(), x, frames, win, [&](float* v) { p.process(v, kCh); });
+            }
+        }
+    }
+    return hub_test_result();
+}
@@ -0,0 +1,107 @@
+// Pipeline::process(float*, ...) and process_block() must not touch the heap
+// once the channel count is settled. Global operator new is replaced by a
+// counting version; the count is armed after a warm-up, for the fused chain
+// (legacy flags) and for a generic chain using every stage kind.
+
+#include "check.h"
+#include "hub/Pipeline.h"
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+static bool g_armed = false;
+static size_t g_allocs = 0;
+
+void* operator new(std::size_t n) {
+    if (g_armed) ++g_allocs;
+    if (n == 0) n = 1;
+    if (void* p = std::malloc(n)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) { return operator new(n); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+    if (g_armed) ++g_allocs;
+    return std::malloc(n ? n : 1);
+}
+void* operator new[](std::size_t n, const std::nothrow_t& t) noexcept { return operator new(n, t); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+static void fill(hub::FrameBlock& blk, size_t n_ch, size_t frames, uint32_t& seed) {
+    blk.clear();
+    blk.n_ch = n_ch;
+    for (size_t i = 0; i < frames; ++i) {
+        float* x = blk.append(i * 5000000ULL);
+        for (size_t c = 0; c < n_ch; ++c) {
+            seed = seed * 1664525u + 1013904223u;
+            x[c] = (float)(seed >> 8) * (1.0f / 16777216.0f) - 0.5f;
+        }
+    }
+}
+
+static void run(const char* name, const hub::PipelineConfig& cfg, size_t n_ch) {
+    for (int lv = 0; lv <= (int)hub::Pipeline::detected_simd(); ++lv) {
+        hub::Pipeline p;
+        p.set_config(cfg);
+        p.set_simd((hub::SimdLevel)lv);
+        p.ensure_initialized(n_ch);
+        p.begin_bias_capture(32);
+
+        uint32_t seed = 1;
+        hub::FrameBlock src, blk;
+        std::vector<float> out(n_ch);
+        // Blocks of varying length, so the warm-up sizes every buffer for the
+        // longest one. Long enough for the bias capture and the FIR blocks.
+        const size_t lens[] = {64, 1, 17, 64, 3};
+        fill(src, n_ch, 64, seed);
+        for (int r = 0; r < 40; ++r) {
+            blk = src;
+            blk.n_frames = lens[r % 5];
+            p.process_block(blk);
+            p.process(src.row(r % 64), out.data(), n_ch);
+            p.process(out.data(), n_ch);
+        }
+
+        g_allocs = 0;
+        g_armed = true;
+        for (int r = 0; r < 200; ++r) {
+            for (size_t i = 0; i < 64; ++i) {
+                p.process(src.row(i), out.data(), n_ch);
+                p.process(out.data(), n_ch);
+            }
+            std::copy(src.x.begin(), src.x.end(), blk.x.begin());
+            blk.n_frames = lens[r % 5];
+            p.process_block(blk);
+        }
+        g_armed = false;
+
+        CHECK(g_allocs == 0, "%s, %zu ch, simd level %d: %zu allocations", name, n_ch, lv, g_allocs);
+    }
+}
+
+int main() {
+    hub::PipelineConfig fused;
+    fused.enable_ma = true;
+    fused.enable_ema = true;
+    fused.enable_notch = true;
+    fused.enable_bias = true;
+    fused.fs_hz = 1000.0;
+
+    hub::PipelineConfig generic;
+    generic.fs_hz = 1000.0;
+    std::string err;
+    const bool ok = hub::parse_stage_chain(
+        "ma:5,ema:0.2,notch:60,hum:50:3,lp:20:4,hp:0.5:2,bp:5:40,firlp:20:31,firlp:20:255,"
+        "median:9,hampel:7,ma:3,bias", generic.stages, err);
+    CHECK(ok, "chain: %s", err.c_str());
+
+    for (size_t n_ch : {1u, 16u, 37u}) {
+        run("fused", fused, n_ch);
+        run("generic", generic, n_ch);
+    }
+    return hub_test_result();
+}
@@ -0,0 +1,83 @@
+// The simulator's ground truth against BruteForce_16x2Solver's difference
+// fit, which takes RC_R * RC_C in sample periods like the simulator's front
+// end. The fit pairs the previous grid point with a new one, so it is exact
+// only when the source sits on grid points: path_hz = fs / 4 hops it along x
+// over -A, 0, A, 0 with y and the height held. On a noise-free stream with
+// no smoothing and no quiet restarts every frame has to land on the true
+// point, for the solver's default RC, a slower front end and a DC-coupled one.
+
+#include "check.h"
+#include "hub/Simulator.h"
+#include "hub/StreamDecoder.h"
+#include "hub/model/BruteForce_16x2.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+static void run(double step, double height, double rc_samples, bool simd) {
+    hub::SimConfig sc;
+    sc.path_hz = sc.fs_hz / 4.0;
+    sc.path_x_m = 0.03;
+    sc.path_y_m = 0.0;
+    sc.path_z_m = height;
+    sc.path_dz_m = 0.0;
+    sc.rc_samples = rc_samples;
+    sc.noise_rms = 0.0;
+    sc.hum_amp = 0.0;
+    sc.drift_rms = 0.0;
+
+    hub::SensorArraySimulator sim;
+    sim.reset(sc);
+    hub::StreamDecoder dec;
+    dec.set_layout(hub::SensorArraySimulator::csv_layout());
+    dec.reset();
+
+    // DC coupled: a time constant long enough that the model is V2 - V1.
+    const double rc = rc_samples > 0.0 ? rc_samples : 1e16;
+    hub::BruteForce_16x2Solver solver;
+    solver.set_grid(-0.06, 0.06, -0.06, 0.06, 0.01, 0.10, step);
+    solver.set_params(1e8, rc / 1e8, 1.0, 0.0);
+    solver.set_simd(simd);
+
+    const size_t frames = 200;
+    hub::FrameBlock blk;
+    std::string pkt;
+    std::vector<float> v(hub::BruteForce_16x2Solver::NSENS);
+    double worst = 0.0;
+    size_t n = 0;
+    for (size_t k = 0; k < frames; ++k) {
+        pkt.clear();
+        const hub::Vec3d r = sim.position(sim.time_s());
+        sim.next_packet(pkt);
+        dec.decode(pkt, 0, blk);
+        CHECK(blk.n_frames == 1, "frame %zu: decoded %zu frames", k, blk.n_frames);
+        if (blk.n_frames != 1) return;
+
+        std::copy(blk.row(0), blk.row(0) + v.size(), v.begin());
+        const hub::BruteForce_16x2Output o = solver.update(v);
+        if (k == 0) continue;   // the first frame only primes the pair
+        CHECK(o.has_pose, "frame %zu: no pose", k);
+        const double d = std::sqrt((o.x - r.x) * (o.x - r.x) + (o.y - r.y) * (o.y - r.y) +
+                                   (o.z - r.z) * (o.z - r.z));
+        CHECK(d <= 0.5 * step, "step %g, z %g, rc %g, frame %zu: %.2f mm from the truth", step, height,
+              rc_samples, k, d * 1e3);
+        worst = std::max(worst, d);
+        ++n;
+    }
+    std::printf("step %g, z %g, rc %g %s: %zu frames, max %.3f mm\n", step, height, rc_samples,
+                simd ? "simd" : "scalar", n, worst * 1e3);
+}
+
+int main() {
+    for (double step : {0.005, 0.0025}) {
+        for (double height : {0.02, 0.04, 0.07}) {
+            for (double rc : {0.05, 5.0, 0.0}) {
+                run(step, height, rc, false);
+                if (hub::BruteForce_16x2Solver::simd_available()) run(step, height, rc, true);
+            }
+        }
+    }
+    return hub_test_result();
+}
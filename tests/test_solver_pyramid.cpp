@@ -0,0 +1,74 @@
+// The pyramid's evaluation budget. Whatever max_evals is, the coarse lattice
+// has to fit in it and be scanned in full, and refining stops at max_evals.
+// The source runs from the middle of the volume out to the far corner, the
+// last point of the coarse lattice, and back.
+
+#include "check.h"
+#include "hub/model/BruteForce_16x2.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using hub::BruteForce_16x2Solver;
+using hub::Vec3d;
+
+static std::vector<float> potentials(const Vec3d& r, double q) {
+    const auto s = BruteForce_16x2Solver::sensor_positions();
+    std::vector<float> v(BruteForce_16x2Solver::NSENS);
+    for (int j = 0; j < BruteForce_16x2Solver::NSENS; ++j) {
+        const double dx = r.x - s[j].x, dy = r.y - s[j].y, dz = r.z - s[j].z;
+        v[j] = (float)(q / std::sqrt(dx * dx + dy * dy + dz * dz));
+    }
+    return v;
+}
+
+// Points of one axis as set_grid() lays them out, then every f-th of them
+// plus the last.
+static size_t lattice(double lo, double hi, double step, int f) {
+    int n = 0;
+    for (double x = lo; x <= hi + 1e-12; x += step) ++n;
+    return (size_t)((n - 1) / f + 1 + ((n - 1) % f ? 1 : 0));
+}
+
+static void run(double step, int top_k, int max_evals) {
+    BruteForce_16x2Solver s;
+    s.set_grid(-0.06, 0.06, -0.06, 0.06, 0.01, 0.10, step);
+    s.set_params(1e8, 1e8, 1.0, 1e-9);
+    s.set_pyramid(true, top_k, max_evals);
+
+    const int L = s.pyramid_levels();
+    const size_t coarse = lattice(-0.06, 0.06, step, 1 << L) * lattice(-0.06, 0.06, step, 1 << L) *
+                          lattice(0.01, 0.10, step, 1 << L);
+    CHECK(L > 0, "step %g, max_evals %d: grid of %zu points not split", step, max_evals, s.grid_size());
+    CHECK(coarse <= (size_t)max_evals, "step %g, top_k %d, max_evals %d: L%d lattice of %zu points", step, top_k,
+          max_evals, L, coarse);
+
+    const Vec3d from{0.0, 0.0, 0.05}, corner{0.06, 0.06, 0.10};
+    const int frames = 12;
+    size_t lo = (size_t)-1, hi = 0;
+    for (int k = 0; k < frames; ++k) {
+        const double t = 1.0 - std::fabs((double)k / (frames / 2) - 1.0);
+        const Vec3d r{from.x + t * (corner.x - from.x), from.y + t * (corner.y - from.y),
+                      from.z + t * (corner.z - from.z)};
+        s.update(potentials(r, 0.05));
+        if (k == 0) continue;   // the first frame only primes the pair
+        const size_t e = s.last_evals();
+        CHECK(e >= coarse && e <= (size_t)max_evals, "step %g, top_k %d, max_evals %d, frame %d: %zu points"
+              " (lattice %zu)", step, top_k, max_evals, k, e, coarse);
+        lo = std::min(lo, e);
+        hi = std::max(hi, e);
+    }
+    std::printf("step %g, top_k %2d, max_evals %4d: L%d, lattice %4zu, %4zu-%4zu points/solve\n", step, top_k,
+                max_evals, L, coarse, lo, hi);
+}
+
+int main() {
+    for (double step : {0.005, 0.0025, 0.001}) {
+        for (int max_evals : {64, 256, 1024, 4096}) {
+            for (int top_k : {1, 4, 16}) run(step, top_k, max_evals);
+        }
+    }
+    return hub_test_result();
+}